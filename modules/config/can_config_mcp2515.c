@@ -28,6 +28,9 @@
  * may need a higher clock frequency (bus idle time - see datasheet).
  *
  * Only one sample time is set, wake-up filters too (Wake On CAN).
+ *
+ * The time quantum is 2 * (BRP + 1) / 4MHz. A bit is 10 TQ (CNF2 0xA0) or
+ * 8 TQ (CNF2 0x90). 500kbps would need less than the 5 TQ minimum.
  */
 uint8_t mcp2515_cnf[NUM_OF_CAN_BITRATES][3] = {
    //! CAN_BITRATE_100_KBPS
@@ -41,6 +44,36 @@ uint8_t mcp2515_cnf[NUM_OF_CAN_BITRATES][3] = {
       0x01,    // CNF1  (1 << BRP0)
       0x90,    // CNF2  (1 << BTLMODE) | (1 << PHSEG11)
       0x42     // CNF3  (1 << WAKFIL)  | (1 << PHSEG21)
+   },
+   //! CAN_BITRATE_50_KBPS
+   {
+      0x03,    // CNF1  (1 << BRP1)    | (1 << BRP0)
+      0xA0,    // CNF2  (1 << BTLMODE) | (1 << PHSEG12)
+      0x42     // CNF3  (1 << WAKFIL)  | (1 << PHSEG21)
+   },
+   //! CAN_BITRATE_83_KBPS
+   {
+      0x02,    // CNF1  (1 << BRP1)
+      0x90,    // CNF2  (1 << BTLMODE) | (1 << PHSEG11)
+      0x42     // CNF3  (1 << WAKFIL)  | (1 << PHSEG21)
+   },
+   //! CAN_BITRATE_250_KBPS
+   {
+      0x00,    // CNF1
+      0x90,    // CNF2  (1 << BTLMODE) | (1 << PHSEG11)
+      0x42     // CNF3  (1 << WAKFIL)  | (1 << PHSEG21)
+   },
+   //! CAN_BITRATE_20_KBPS
+   {
+      0x09,    // CNF1  (1 << BRP3)    | (1 << BRP0)
+      0xA0,    // CNF2  (1 << BTLMODE) | (1 << PHSEG12)
+      0x42     // CNF3  (1 << WAKFIL)  | (1 << PHSEG21)
+   },
+   //! CAN_BITRATE_33_KBPS
+   {
+      0x05,    // CNF1  (1 << BRP2)    | (1 << BRP0)
+      0xA0,    // CNF2  (1 << BTLMODE) | (1 << PHSEG12)
+      0x42     // CNF3  (1 << WAKFIL)  | (1 << PHSEG21)
    }
 };
 
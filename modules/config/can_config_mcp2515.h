@@ -50,8 +50,18 @@ typedef enum
    CAN_BITRATE_100_KBPS = 0,
    //! 125kbps
    CAN_BITRATE_125_KBPS = 1,
+   //! 50kbps
+   CAN_BITRATE_50_KBPS  = 2,
+   //! 83.3kbps
+   CAN_BITRATE_83_KBPS  = 3,
+   //! 250kbps
+   CAN_BITRATE_250_KBPS = 4,
+   //! 20kbps
+   CAN_BITRATE_20_KBPS  = 5,
+   //! 33.3kbps
+   CAN_BITRATE_33_KBPS  = 6,
    //! maximum index of possible CAN bitrates
-   NUM_OF_CAN_BITRATES  = 2         // always the last one!
+   NUM_OF_CAN_BITRATES  = 7         // always the last one!
 } eCanBitRate;
 
 /**
@@ -64,8 +74,15 @@ typedef enum
 {
    //! chip 1 (master CAN)
    CAN_CHIP1      = 0,
+#ifdef CAN_SECOND_CHIP
+   //! chip 2 (second CAN, e.g. powertrain)
+   CAN_CHIP2      = 1,
+   //! always the last one!
+   NUM_OF_MCP2515 = 2
+#else
    //! always the last one!
    NUM_OF_MCP2515 = 1
+#endif
 } eChipSelect;
 
 /**************************************************************************/
@@ -74,6 +91,33 @@ typedef enum
 
 // Port definitions to access the defined MCP2515
 
+#ifdef CAN_SECOND_CHIP
+
+/**
+ * \def CAN_CS_PORTS
+ * \brief definition of cs port pins for each can chip
+ *
+ * These pins are used for chip select signal to each MCP2515. This
+ * structure has to correspond with the chip select enumeration.
+ * \sa eChipSelect
+ */
+#define CAN_CS_PORTS  SET_PORT_PTR(B,2), SET_PORT_PTR(B,1)
+
+/**
+ * \def CAN_INT_PORTS
+ * \brief definition of int port pins for each can chip
+ *
+ * These pins are used for interrupt signal of each MCP2515. This
+ * structure has to correspond with the chip select enumeration.
+ *
+ * Both INT lines are also wired-AND to INT0 (PD2) by diodes, so PD2 of the
+ * first chip is low, if any chip has an interrupt pending.
+ * \sa eChipSelect
+ */
+#define CAN_INT_PORTS SET_PORT_PTR(D,2), SET_PORT_PTR(B,0)
+
+#else
+
 /**
  * \def CAN_CS_PORTS
  * \brief definition of cs port pins for each can chip
@@ -94,6 +138,8 @@ typedef enum
  */
 #define CAN_INT_PORTS SET_PORT_PTR(D,2)
 
+#endif
+
 /*! @} */
 
 
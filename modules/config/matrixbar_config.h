@@ -47,7 +47,35 @@
  *
  * \see P_MATRIXBAR_COL
  */
-#define MATRIXBAR_NUM_COLS    1
+#ifdef PDC_ALL_SENSORS
+   #define MATRIXBAR_NUM_COLS 2
+#else
+   #define MATRIXBAR_NUM_COLS 1
+#endif
+
+/**
+ * \brief number of column pins multiplexed
+ *
+ * These are the pins set in the masks of P_MATRIXBAR_COL.
+ *
+ * \see P_MATRIXBAR_COL
+ */
+#ifdef PDC_ALL_SENSORS
+   #define MATRIXBAR_COLUMNS  4
+#else
+   #define MATRIXBAR_COLUMNS  2
+#endif
+
+/**
+ * \brief time to refresh all columns once in ticks of Timer2 (clk/1024)
+ *
+ * Each column is shown for the same part of it, so the refresh rate and
+ * duty cycle of a column stay the same with any number of columns. 42
+ * ticks are 10.75ms or 93Hz (4MHz), which is free of flicker.
+ *
+ * \see TIMER2_COMPARE_VALUE
+ */
+#define MATRIXBAR_FRAME_TICKS 42
 
 /**
  * \brief maximum value which causes all bargraph pins to be high
@@ -121,9 +149,17 @@
  * Value:
  * | 0   0   0   0   0   1   0   0   1   0   1   1   1   0   1   1 |
  * \endcode
+ *
+ * PD1 is the TX pin of the UART. If the debug channel is used, this row is
+ * not available.
  */
+#ifdef DEBUG_CHANNEL
+#define P_MATRIXBAR_ROW       {&DDR(C), &PORT(C), 0x3F}, \
+                              {&DDR(D), &PORT(D), 0x19}
+#else
 #define P_MATRIXBAR_ROW       {&DDR(C), &PORT(C), 0x3F}, \
                               {&DDR(D), &PORT(D), 0x1B}
+#endif
 
 /**
  * \def P_MATRIXBAR_COL
@@ -134,8 +170,16 @@
  * P_MATRIXBAR_ROW for details.
  *
  * \see P_MATRIXBAR_ROW
+ *
+ * Showing all PDC sensors uses PB0 and PB1 as additional columns. The
+ * latency test pin and debug dump request are not available then.
  */
+#ifdef PDC_ALL_SENSORS
+#define P_MATRIXBAR_COL       {&DDR(D), &PORT(D), 0x60}, \
+                              {&DDR(B), &PORT(B), 0x03}
+#else
 #define P_MATRIXBAR_COL       {&DDR(D), &PORT(D), 0x60}
+#endif
 
 /**
  * \def P_MATRIXBAR_COL_INVERTED
@@ -28,8 +28,13 @@
  *
  * This is used to determine SPI speed in dependence from main clock. The
  * speed results as follows: Fspi = Fosc/SPI_PRESCALER
+ *
+ * The MCP2515 takes up to 10MHz, so the fastest setting is used. A byte is
+ * transferred within 16 cycles then, which is less than entering and
+ * leaving an interrupt service routine. So polling SPIF is the cheapest
+ * way to wait for it.
  */
-#define SPI_PRESCALER      8
+#define SPI_PRESCALER      2
 #endif
 
 
@@ -24,6 +24,8 @@
 #ifndef TIMER_CONFIG_H_
 #define TIMER_CONFIG_H_
 
+#include "config/matrixbar_config.h"
+
 /**
  * \def TIMER0_PRESCALER
  * \brief TIMER0 prescaler settings
@@ -98,12 +100,19 @@
 /**
  * @brief Timer 2 Output Compare Value
  *
- * The value given calculates to approx. 5ms (4MHz@1024 prescale factor).
- * Correctly, it would be 5.12ms.
+ * Derived from the number of columns of the matrixbar. Two columns give 20,
+ * which calculates to approx. 5ms per column (4MHz@1024 prescale factor).
+ * Correctly, it would be 5.38ms.
  *
  * Default value should be set to MAX (0xFF)
+ *
+ * May be overridden by the build to benchmark other multiplex settings.
+ *
+ * \see MATRIXBAR_FRAME_TICKS
  */
-#define TIMER2_COMPARE_VALUE  20
+#ifndef TIMER2_COMPARE_VALUE
+   #define TIMER2_COMPARE_VALUE  ((MATRIXBAR_FRAME_TICKS / MATRIXBAR_COLUMNS) - 1)
+#endif
 
 #endif
 
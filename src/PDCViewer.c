@@ -22,12 +22,27 @@
 #include "can/can_mcp2515.h"
 #include "timer/timer.h"
 #include "matrixbar/matrixbar.h"
+#include "hal.h"
+#include "display.h"
+#include "events.h"
+#include "power.h"
+#include "sleep_policy.h"
+#include "systick.h"
+#include "bus_stats.h"
+#include "can_autobaud.h"
+#include "can_fifo.h"
+#include "can_rx.h"
+#include "config_store.h"
+#include "debug.h"
+#include "mcp2515_burst.h"
+#include "mcp2515_shadow.h"
+#include "pdc_decode.h"
+#include "pdc_filter.h"
+#include "profiler.h"
+#include "recorder.h"
+#include "telemetry.h"
 #include "PDCViewer.h"
 
-#include <avr/interrupt.h>
-#include <avr/sleep.h>
-#include <avr/cpufunc.h>
-
 // === GLOBALS ===============================================================
 
 /**
@@ -42,26 +57,27 @@
  */
 state_t fsmState       = INIT;
 
-/**
- * \brief set current column
- */
-uint8_t columnInUse    = 0;
+//! store values of all sensors, see NUM_OF_PDC_SENSORS
+uint8_t pdcValueStored[NUM_OF_PDC_SENSORS];
 
-/**
- * \brief trigger active column of display
- */
-bool columnTrigger       = false;
+//! values of all sensors as decoded, before filtering (see pdc_filter.h)
+static uint8_t pdcValueRaw[NUM_OF_PDC_SENSORS];
 
-/**
- * \brief used number of columns
- *
- * This value should match number of columns of matrixbar, but need not
- * necessarily. In this case it matches.
- */
-#define NUM_OF_PDC_VALUES_SHOWN  2
+//! time each sensor was decoded last (see systick.h)
+static uint16_t pdcValueStamp[NUM_OF_PDC_SENSORS];
+
+//! age of a sensor value blanked, see PDC_STALE_AGE
+static uint16_t pdcStaleAge = PDC_STALE_AGE;
+
+//! sensor values blanked, since they were stale
+uint16_t pdcStaleCount = 0;
 
-//! store max value of left and right side
-uint8_t pdcValueStored[NUM_OF_PDC_VALUES_SHOWN] = {PDC_OUT_OF_RANGE, PDC_OUT_OF_RANGE};
+//! values shown were decoded since the last PDC inactive timeout
+static bool pdcValuesShown = false;
+
+//! controllers detecting the bitrate (bit per chip), see probeCAN(); kept
+//! while sleeping for those without a bitrate locked, see wakeUp()
+static uint8_t canProbing = 0;
 
 // === MAIN LOOP =============================================================
 
@@ -72,28 +88,64 @@ uint8_t pdcValueStored[NUM_OF_PDC_VALUES_SHOWN] = {PDC_OUT_OF_RANGE, PDC_OUT_OF_
  * before entering it. Any error in the init process will result in
  * entering the error state.
  *
+ * While running, the main loop sleeps in idle mode until an ISR posts an
+ * event (see events.h). Only the display is multiplexed by the ISR of
+ * Timer2 meanwhile. Each change of the state is counted, see power.h.
+ *
  * \returns  nothing, since it does not return
  **/
-#ifndef __DOXYGEN__
+#if !defined(__DOXYGEN__) && defined(__AVR__)
 int __attribute__((OS_main)) main(void)
 #else
 int main(void)
 #endif
 {
+   state_t lastState = INIT;
+   uint8_t events;
 
+   resetPdcValues();
    initHardware();
 
 #ifndef ___NO_CAN___
    if(true == initCAN())
    {
 #endif
-      while (1)
+      while (hal_running())
       {
          switch (fsmState)
          {
             case RUNNING:
             {
-               run();
+               events = events_wait();
+               if(events & EVENT_FRAME)
+               {
+                  power_frame();
+               }
+#ifndef ___NO_CAN___
+               if(events & EVENT_FRAME)
+#endif
+               {
+                  run();
+               }
+               if(events & EVENT_TICK)
+               {
+                  power_tick();
+#ifndef ___NO_CAN___
+                  probeCAN();
+#endif
+                  checkPdcTimeout();
+                  checkStaleValues();
+                  bus_stats_poll();
+                  profiler_poll();
+                  debug_poll();
+                  telemetry_poll();
+               }
+               // frames of the same batch restarted Timer1 in run(), the
+               // capture interrupt was already pending then
+               if((events & EVENT_BUS_SILENT) && !(events & EVENT_FRAME))
+               {
+                  fsmState = SLEEP_DETECTED;
+               }
                break;
             }
 
@@ -127,13 +179,24 @@ int main(void)
                break;
             }
          }
+
+         if(fsmState != lastState)
+         {
+            lastState = fsmState;
+            power_enter(fsmState);
+            telemetry_state(fsmState);
+            recorder_event(RECORDER_STATE, fsmState);
+         }
       }
+      // only reached, if the simulation of the host build ends
+      return 0;
 #ifndef ___NO_CAN___
    }
 #endif
 
    // something went wrong here
    errorState();
+   return 1;
 }
 
 
@@ -148,6 +211,8 @@ int main(void)
  */
 void sleepDetected(void)
 {
+   PROFILE_BEGIN(PROF_SLEEP_DETECTED);
+
    // stop timer for now
    stopTimer1();
    stopTimer2();
@@ -155,13 +220,42 @@ void sleepDetected(void)
    led_all_off();
    matrixbar_clear();
    // all PDC values to default
-   pdcValueStored[0] = PDC_OUT_OF_RANGE;
-   pdcValueStored[1] = PDC_OUT_OF_RANGE;
+   resetPdcValues();
+   updateDisplay();
+   pdcValuesShown = false;
+   // nothing left to do before waking up
+   events_take();
+   sleep_policy_sleep();
 
 #ifndef ___NO_CAN___
-   // set CAN controller to sleep
-   mcp2515_sleep(CAN_CHIP1, INT_SLEEP_WAKEUP_BY_CAN);
+   uint8_t chip;
+
+   // no reception while the SPI is used here
+   hal_can_irq_disable();
+   can_fifo_flush();
+   // set CAN controllers to sleep, any of them wakes up
+   for(chip = 0; chip < NUM_OF_MCP2515; ++chip)
+   {
+      // still silent, keep the bitrate to start with until woken up
+      if(canProbing & (1 << chip))
+      {
+         can_autobaud_stop((eChipSelect)chip);
+      }
+      // detected again on wake up, e.g. installed while the car was off
+      if(!can_autobaud_result((eChipSelect)chip)->locked)
+      {
+         canProbing |= (uint8_t)(1 << chip);
+      }
+      mcp2515_sleep((eChipSelect)chip, INT_SLEEP_WAKEUP_BY_CAN);
+   }
 #endif
+
+   PROFILE_END(PROF_SLEEP_DETECTED);
+
+   // settings changed while running, e.g. the bitrate detected; not part
+   // of the probe, each byte written takes ~8.5ms and hal_cycles() wraps
+   // around every ~16ms
+   config_save();
 }
 
 /**
@@ -179,53 +273,72 @@ void sleepDetected(void)
  */
 void sleeping(void)
 {
-   cli();
+   // the UART stops while powered down
+   debug_flush();
+   telemetry_flush();
 
-   // don't wake up with trigger set
-   columnTrigger = false;
+   hal_irq_disable();
 
    // enable wakeup interrupt INT0
-   GICR  |= EXTERNAL_INT0_ENABLE;
+   hal_can_irq_enable();
 
    // let's sleep...
-   set_sleep_mode(SLEEP_MODE_PWR_DOWN);
-   // sleep_mode() has a possible race condition in it, so splitting it
-   sleep_enable();
-   sei();
-   sleep_cpu();
-   sleep_disable();
-
-   // just in case...
-   _NOP();
-   _NOP();
-   _NOP();
+   hal_sleep(SLEEP_MODE_PWR_DOWN);
 
    // disable interrupt: precaution, if signal lies too long on pin
-   GICR  &= ~(EXTERNAL_INT0_ENABLE);
+   hal_can_irq_disable();
 }
 
 /**
  * \brief wake up CAN and reinitialize the timers
  *
  * Now the AVR has woken up. Timers needs to be restarted and the CAN
- * controllers will also need to enter their working mode.
+ * controllers will also need to enter their working mode. Registers of the
+ * controller lost while sleeping are written again from the copy taken by
+ * setupCAN(). Controllers without a bitrate locked are initialized again
+ * and listen to their bus, see probeCAN().
  */
 void wakeUp(void)
 {
-   cli();
+   PROFILE_BEGIN(PROF_WAKEUP);
+
+   hal_irq_disable();
 
 #ifndef ___NO_CAN___
-   // wakeup CAN bus
-   mcp2515_wakeup(CAN_CHIP1, INT_SLEEP_WAKEUP_BY_CAN);
+   uint8_t chip;
+
+   for(chip = 0; chip < NUM_OF_MCP2515; ++chip)
+   {
+      if(canProbing & (1 << chip))
+      {
+         // no bitrate locked yet, listen again as on power on (see probeCAN())
+         (void)can_init_mcp2515((eChipSelect)chip, can_autobaud_start((eChipSelect)chip),
+                                LISTEN_ONLY_MODE);
+         can_autobaud_begin((eChipSelect)chip);
+         continue;
+      }
+      // wakeup CAN bus
+      mcp2515_wakeup((eChipSelect)chip, INT_SLEEP_WAKEUP_BY_CAN);
+      // restore configuration, if lost while sleeping
+      mcp2515_shadow_verify((eChipSelect)chip, LISTEN_ONLY_MODE);
+   }
+   // the time asleep doesn't count
+   bus_stats_wake();
+   // receive frames by interrupt again
+   hal_can_irq_enable();
 #endif
 
    // restart timers
    restartTimer1();
+   sleep_policy_wake();
+   hal_timer1_set_compare(sleep_policy_bus_timeout());
    restartTimer2();
    // set status LED to show run state
    led_on(statusLed);
 
-   sei();
+   hal_irq_enable();
+
+   PROFILE_END(PROF_WAKEUP);
 }
 
 /**
@@ -233,27 +346,54 @@ void wakeUp(void)
  */
 void run(void)
 {
-#ifndef ___NO_CAN___
-   can_t    msg;
+   PROFILE_BEGIN(PROF_RUN);
 
-   if (can_check_message_received(CAN_CHIP1))
+   bool    changed = false;
+   uint8_t decoded = 0;
+
+#ifndef ___NO_CAN___
+   const can_t* msg;
+   bool         received = false;
+   uint8_t      slots;
+   uint16_t     now;
+   uint8_t      i;
+
+   // frames are received by ISR(INT0_vect)
+   while (NULL != (msg = can_fifo_peek()))
    {
-      // try to read message
-      if (can_get_message(CAN_CHIP1, &msg))
-      {
-         // reset timer counter, since there is activity on master CAN bus
-         setTimer1Count(0);
+      received = true;
 
-         // fetch information from CAN
-         if ((PDC_CAN_ID == msg.msgId) && (0 == msg.header.rtr))
+      // fetch information from CAN, see pdc_decode.c
+      slots = (0 == msg->header.rtr) ? pdc_decode(msg, pdcValueRaw) : 0;
+      bus_stats_decoded(0 != slots);
+      if (0 != slots)
+      {
+         // smooth the distances, see pdc_filter.h
+         PROFILE_BEGIN(PROF_FILTER);
+         pdc_filter(slots, pdcValueRaw, pdcValueStored);
+         PROFILE_END(PROF_FILTER);
+         now = systick_now();
+         for(i = 0; i < NUM_OF_PDC_SENSORS; ++i)
          {
-            // fetch only rear sensors
-            // left
-            pdcValueStored[0] = (msg.data[2] < msg.data[6]) ? msg.data[2] : msg.data[6];
-            // right
-            pdcValueStored[1] = (msg.data[3] < msg.data[7]) ? msg.data[3] : msg.data[7];
+            if(slots & (1 << i))
+            {
+               pdcValueStamp[i] = now;
+            }
          }
+         hal_trace_decoded(msg);
+         decoded |= slots;
+         changed  = true;
       }
+      can_fifo_release();
+   }
+
+   if(true == received)
+   {
+      // reset timer counter, since there is activity on master CAN bus,
+      // and adapt the timeout to the cadence of the frames
+      sleep_policy_frame(hal_timer1_count());
+      setTimer1Count(0);
+      hal_timer1_set_compare(sleep_policy_bus_timeout());
    }
 #else
    // testing w/o CAN
@@ -262,15 +402,17 @@ void run(void)
    setTimer1Count(0);
 #endif
 
-   if(true == columnTrigger)
+   // new values are shown by ISR(TIMER2_COMP_vect) with the next column
+   if(true == changed)
    {
-      columnTrigger = false;
-      // trigger value presentation in matrixbar
-      matrixbar_reset_col(columnInUse % NUM_OF_PDC_VALUES_SHOWN);
-      ++columnInUse;
-      matrixbar_set(pdcValueStored[columnInUse % NUM_OF_PDC_VALUES_SHOWN]);
-      matrixbar_set_col(columnInUse % NUM_OF_PDC_VALUES_SHOWN);
+      pdcValuesShown = true;
+      PROFILE_BEGIN(PROF_MATRIXBAR);
+      updateDisplay();
+      PROFILE_END(PROF_MATRIXBAR);
+      telemetry_distances(decoded, pdcValueStored);
    }
+
+   PROFILE_END(PROF_RUN);
 }
 
 /**
@@ -281,8 +423,10 @@ void run(void)
  */
 void errorState(void)
 {
+   // the first pass keeps the history of the failure
+   recorder_save(fsmState);
    led_toggle(statusLed);
-   _delay_ms(500);
+   hal_delay_ms(500);
 }
 
 
@@ -291,33 +435,78 @@ void errorState(void)
 /**
  * \brief interrupt service routine for Timer1 capture
  *
- * Timer1 input capture interrupt (~15s 4MHz@1024 prescale factor)
+ * Timer1 input capture interrupt, after the bus silent timeout of the sleep
+ * policy (see sleep_policy_bus_timeout()). The main loop prepares the sleep
+ * mode then.
  **/
 ISR(TIMER1_CAPT_vect)
 {
-   fsmState = SLEEP_DETECTED;
+   PROFILE_BEGIN(PROF_ISR_TIMER1);
+   recorder_event(RECORDER_TIMER1, 0);
+   events_post(EVENT_BUS_SILENT);
+   PROFILE_END(PROF_ISR_TIMER1);
 }
 
 /**
  * \brief interrupt service routine for Timer2 capture
  *
  * Timer2 input compare interrupt (~5ms 4MHz@1024 prescale factor) is used
- * to trigger the multiplexing of the display (bargraph) sides. At ~5ms the
- * flickering shouldn't be so obvious.
+ * for the multiplexing of the display (bargraph) sides. The next column of
+ * the framebuffer is shown directly, so the on-time of a column does not
+ * depend on the work of run(). At ~5ms the flickering shouldn't be so
+ * obvious. Each refresh of all columns is posted as a tick to the main loop.
  **/
 ISR(TIMER2_COMP_vect)
 {
-   columnTrigger = true;
+   PROFILE_BEGIN(PROF_ISR_TIMER2);
+   recorder_event(RECORDER_TIMER2, 0);
+   // the period just ended, display_scan() sets the next one
+   systick_advance((uint16_t)hal_timer2_compare() + 1);
+   if(display_scan())
+   {
+      events_post(EVENT_TICK);
+   }
+   PROFILE_END(PROF_ISR_TIMER2);
 }
 
 /**
  * \brief interrupt service routine for external interrupt 0
  *
- * External Interrupt0 handler to wake up from CAN activity
+ * External Interrupt0 is connected to the INT lines of the MCP2515. It
+ * wakes up from CAN activity and drains all received frames into the FIFO
+ * for run(), see can_rx.h for the order the controllers are served in.
+ *
+ * Reading the frames via SPI takes most of the time, so all interrupts but
+ * INT0 itself are enabled meanwhile: Timer2 keeps scanning the display on
+ * time. Frames put into the FIFO are posted as one event to the main loop
+ * after interrupts are disabled again, since posting is not atomic.
+ *
+ * The INT line is low level triggered, so the ISR is entered again as long
+ * as any MCP2515 has an interrupt flag set.
  **/
 ISR(INT0_vect)
 {
-   // does not need to do anything, but needs to be there
+   PROFILE_BEGIN(PROF_ISR_INT0);
+
+#ifndef ___NO_CAN___
+   bool queued;
+
+   hal_can_irq_disable();
+   hal_irq_enable();
+
+   queued = can_rx_service();
+
+   hal_irq_disable();
+   hal_can_irq_enable();
+
+   recorder_event(RECORDER_INT0, queued);
+   if(queued)
+   {
+      events_post(EVENT_FRAME);
+   }
+#endif
+
+   PROFILE_END(PROF_ISR_INT0);
 }
 
 
@@ -328,7 +517,8 @@ ISR(INT0_vect)
  * \brief Initialize Hardware
  *
  * Setting up the peripherals to the AVR and the wake-up interrupt
- * trigger.
+ * trigger. The settings are loaded from the EEPROM first (see
+ * config_store.h).
  *
  * * \ref page_timers to trigger events
  *
@@ -339,10 +529,41 @@ ISR(INT0_vect)
  */
 void initHardware(void)
 {
+   const config_t* settings;
+   sleep_policy_t  policy;
+
+   // binary records via UART (if enabled), the debug channel uses them
+   telemetry_init();
+   // measurement of the hot path (if enabled)
+   profiler_init();
+   hal_trace_init();
+
+   // settings kept in the EEPROM
+   PROFILE_BEGIN(PROF_CONFIG);
+   config_load();
+   PROFILE_END(PROF_CONFIG);
+   settings = config_get();
+   pdc_decode_set_id(settings->pdcCanId);
+   bus_stats_init(settings->pdcCanId);
+   pdc_filter_set_mode(settings->filter);
+   pdcStaleAge = settings->staleAge;
+   bargraph_set_options(0 != (settings->bargraph & CONFIG_BARGRAPH_REVERSE),
+                        0 != (settings->bargraph & CONFIG_BARGRAPH_INVERTED));
+   display_set_brightness(settings->brightness);
+   policy.pdcShift = settings->pdcShift;
+   policy.pdcMin   = settings->pdcMin;
+   policy.pdcMax   = settings->pdcMax;
+   policy.busShift = settings->busShift;
+   policy.busMin   = settings->busMin;
+   policy.busMax   = settings->busMax;
+   sleep_policy_set(&policy);
+
    // set timer for bussleep detection
    initTimer1(TimerCompare);
-   // set timer for PDC off detection
+   hal_timer1_set_compare(sleep_policy_bus_timeout());
+   // set timer for PDC off detection, the display is multiplexed by it
    initTimer2(TimerCompare);
+   hal_timer2_set_compare(settings->timer2Compare);
 
 #ifndef ___NO_CAN___
    // initialize the hardware SPI with default values set in spi/spi_config.h
@@ -350,14 +571,18 @@ void initHardware(void)
    spi_master_init();
 #endif
 
-   // init matrix bargraph
+   // init matrix bargraph and its framebuffer
    matrixbar_init();
+   display_init();
    // init status LED and switch to on
    led_init();
    led_on(statusLed);
 
    // set wakeup interrupt trigger on low level
-   MCUCR |= EXTERNAL_INT0_TRIGGER;
+   hal_can_irq_init();
+
+   // timers need their interrupts
+   hal_irq_enable();
 
 #ifdef ___NO_CAN___
    // It's not done in initCAN()!
@@ -371,39 +596,40 @@ void initHardware(void)
  * Calls can_init_mcp2515 for each attached CAN controller and setting up
  * bit rate. If an error occurs some status LEDs will indicate it.
  *
+ * The bit rate of each bus is detected before the filters are set,
+ * starting with the one cached in the EEPROM (see can_autobaud.h). The
+ * detection continues in the main loop, see probeCAN().
+ *
  * See chapter \ref page_can_bus for further details.
  *
  * @return true if all is ok. Otherwise false is returned.
  */
 bool initCAN(void)
 {
-   bool retVal = can_init_mcp2515(CAN_CHIP1, CAN_BITRATE_100_KBPS, LISTEN_ONLY_MODE);
-   /*
-    * SIDH -> bits 3..10 of CAN ID @ bits 0..7
-    * SIDL -> bits 0..2  of CAN ID @ bits 5..7
-    */
-   uint8_t filterVals[MAX_LENGTH_OF_FILTER_SETUP] = {((PDC_CAN_ID >> 3) & 0xFF), // SIDH
-                                                     ((PDC_CAN_ID << 5) & 0xE0), // SIDL
-                                                     0xFF,                       // EID8
-                                                     0xFF};                      // EID0
+   bool        retVal = true;
+   eChipSelect chip;
+
+   canProbing = 0;
+   for(chip = CAN_CHIP1; chip < NUM_OF_MCP2515; ++chip)
+   {
+      retVal = can_init_mcp2515(chip, can_autobaud_start(chip), LISTEN_ONLY_MODE);
+      if(false == retVal)
+      {
+         recorder_event(RECORDER_INIT_FAILED, chip);
+         break;
+      }
+      // listen to the bus, until the bit rate is known
+      can_autobaud_begin(chip);
+      canProbing |= (uint8_t)(1 << chip);
+   }
+
    if(true == retVal)
    {
-      // set filters to currently used can message, ignore anything else
-      set_mode_mcp2515(CAN_CHIP1, CONFIG_MODE);
-      // masks
-      setFilters(CAN_CHIP1, RXM0SIDH, filterVals);
-      setFilters(CAN_CHIP1, RXM1SIDH, filterVals);
-      // filters
-      setFilters(CAN_CHIP1, RXF0SIDH, filterVals);
-      setFilters(CAN_CHIP1, RXF1SIDH, filterVals);
-      /* not yet...
-      setFilters(CAN_CHIP1, RXF2SIDH, filterVals);
-      setFilters(CAN_CHIP1, RXF3SIDH, filterVals);
-      setFilters(CAN_CHIP1, RXF4SIDH, filterVals);
-      setFilters(CAN_CHIP1, RXF5SIDH, filterVals);
-      */
-      // back to normal
-      set_mode_mcp2515(CAN_CHIP1, LISTEN_ONLY_MODE);
+      // bus silent timeout starts now, even if detection took longer
+      setTimer1Count(0);
+      events_take();
+      // receive frames by interrupt
+      hal_can_irq_enable();
    }
    // If an error roccurs, the main loop is not started, so it's ok to set
    // the state here.
@@ -411,3 +637,198 @@ bool initCAN(void)
    return retVal;
 }
 
+/**
+ * \brief continue the detection of the bit rates
+ *
+ * Called with each refresh of the display while running. A controller
+ * done is set up at once and receives by interrupt, while the others are
+ * still listening. No bus waits for the detection of another one.
+ */
+void probeCAN(void)
+{
+   uint8_t chip;
+
+   for(chip = 0; chip < NUM_OF_MCP2515; ++chip)
+   {
+      if(canProbing & (1 << chip))
+      {
+         // no reception while the SPI is used here
+         hal_can_irq_disable();
+         if(can_autobaud((eChipSelect)chip))
+         {
+            setupCAN((eChipSelect)chip);
+            canProbing &= (uint8_t)~(1 << chip);
+         }
+         hal_can_irq_enable();
+      }
+   }
+}
+
+/**
+ * \brief set up a controller with the bit rate detected
+ *
+ * \param chip controller
+ */
+void setupCAN(eChipSelect chip)
+{
+   uint8_t regs[PDC_FILTERS_PER_ROW * MAX_LENGTH_OF_FILTER_SETUP];
+   uint8_t i;
+
+   // set filters to the messages decoded, ignore anything else
+   set_mode_mcp2515(chip, CONFIG_MODE);
+   // both masks in one burst
+   setFilterId(&regs[0], pdc_decode_mask());
+   setFilterId(&regs[MAX_LENGTH_OF_FILTER_SETUP], pdc_decode_mask());
+   mcp2515_write_burst(chip, RXM0SIDH, regs, 2 * MAX_LENGTH_OF_FILTER_SETUP);
+   // filters RXF0..RXF2 and RXF3..RXF5 in one burst each
+   for(i = 0; i < PDC_NUM_OF_FILTERS; ++i)
+   {
+      setFilterId(&regs[(i % PDC_FILTERS_PER_ROW) * MAX_LENGTH_OF_FILTER_SETUP],
+                  pdc_decode_filter(i));
+      if((PDC_FILTERS_PER_ROW - 1) == (i % PDC_FILTERS_PER_ROW))
+      {
+         mcp2515_write_burst(chip, (i < PDC_FILTERS_PER_ROW) ? RXF0SIDH : RXF3SIDH,
+                             regs, sizeof(regs));
+      }
+   }
+   // use both receive buffers
+   mcp2515_rx_setup(chip);
+   // back to normal
+   set_mode_mcp2515(chip, LISTEN_ONLY_MODE);
+   // checked on wake up
+   mcp2515_shadow_capture(chip);
+}
+
+/**
+ * \brief fill registers of a mask or filter with a standard id
+ *
+ * \code
+ * SIDH -> bits 3..10 of CAN ID @ bits 0..7
+ * SIDL -> bits 0..2  of CAN ID @ bits 5..7
+ * \endcode
+ *
+ * EXIDE of the filters is not set, so only standard frames are accepted.
+ * EID8 and EID0 are cleared: for standard frames they compare the data
+ * bytes 0 and 1, which the masks must not restrict.
+ *
+ * \param regs SIDH, SIDL, EID8 and EID0 of mask or filter to fill
+ * \param id 11bit CAN id or mask
+ */
+void setFilterId(uint8_t* regs, uint16_t id)
+{
+   regs[0] = (uint8_t)((id >> 3) & 0xFF);    // SIDH
+   regs[1] = (uint8_t)((id << 5) & 0xE0);    // SIDL
+   regs[2] = 0x00;                           // EID8 (data byte 0)
+   regs[3] = 0x00;                           // EID0 (data byte 1)
+}
+
+/**
+ * \brief set all sensor values to PDC_OUT_OF_RANGE
+ */
+void resetPdcValues(void)
+{
+   uint8_t i;
+
+   for(i = 0; i < NUM_OF_PDC_SENSORS; ++i)
+   {
+      pdcValueStored[i] = PDC_OUT_OF_RANGE;
+      pdcValueRaw[i]    = PDC_OUT_OF_RANGE;
+   }
+   pdc_filter_reset((uint8_t)((1 << NUM_OF_PDC_SENSORS) - 1));
+}
+
+/**
+ * \brief reset the values shown, if PDC is inactive
+ *
+ * Timer1 counts the time since the last frame. If no PDC frame was
+ * received for the PDC inactive timeout (see sleep_policy.h), the stale
+ * values are reset, so the LEDs go dark long before the bus sleeps.
+ */
+void checkPdcTimeout(void)
+{
+   if((true == pdcValuesShown) && (hal_timer1_count() >= sleep_policy_pdc_timeout()))
+   {
+      pdcValuesShown = false;
+      resetPdcValues();
+      updateDisplay();
+   }
+}
+
+/**
+ * \brief reset the values of sensors not decoded for PDC_STALE_AGE
+ *
+ * Timer1 is reset by any frame, so checkPdcTimeout() doesn't notice the
+ * PDC message missing on a busy bus. Each sensor value carries the time
+ * it was decoded instead. The ticks of systick.h wrap around after
+ * ~16.7s, but values are checked with each refresh of the display and
+ * blanked long before.
+ */
+void checkStaleValues(void)
+{
+   uint8_t stale = 0;
+   uint8_t i;
+
+   if(SYSTICK_NEVER == pdcStaleAge)
+   {
+      return;
+   }
+
+   for(i = 0; i < NUM_OF_PDC_SENSORS; ++i)
+   {
+      if((PDC_OUT_OF_RANGE != pdcValueStored[i]) &&
+         (systick_since(pdcValueStamp[i]) >= pdcStaleAge))
+      {
+         pdcValueStored[i] = PDC_OUT_OF_RANGE;
+         stale            |= (uint8_t)(1 << i);
+         ++pdcStaleCount;
+      }
+   }
+
+   if(0 != stale)
+   {
+      // the next value decoded is not compared with the stale one
+      pdc_filter_reset(stale);
+      updateDisplay();
+   }
+}
+
+/**
+ * \brief show the stored PDC values
+ *
+ * Writes the value of each column into the framebuffer.
+ */
+void updateDisplay(void)
+{
+   uint8_t values[NUM_OF_PDC_VALUES_SHOWN];
+   uint8_t col;
+
+   for(col = 0; col < NUM_OF_PDC_VALUES_SHOWN; ++col)
+   {
+      values[col] = getColumnValue(col);
+   }
+   display_update(values);
+}
+
+/**
+ * \brief get value shown in a column
+ *
+ * The nearest of the sensors shown in the column.
+ *
+ * \param col column of the matrixbar
+ * \return value to set
+ */
+uint8_t getColumnValue(uint8_t col)
+{
+   const uint8_t* sensor = &pdcValueStored[col * PDC_SENSORS_PER_COLUMN];
+   uint8_t        value  = sensor[0];
+   uint8_t        i;
+
+   for(i = 1; i < PDC_SENSORS_PER_COLUMN; ++i)
+   {
+      if(sensor[i] < value)
+      {
+         value = sensor[i];
+      }
+   }
+   return value;
+}
@@ -21,6 +21,9 @@
 #ifndef PDCVIEWER_H_
 #define PDCVIEWER_H_
 
+#include "config/matrixbar_config.h"
+#include "can/can_mcp2515.h"
+
 // === DEFINITIONS ===========================================================
 
 /**
@@ -67,6 +70,56 @@
  */
 #define PDC_CAN_ID               0x54B
 
+/**
+ * \brief age of a sensor value blanked
+ *
+ * A value not decoded again for this time is set to PDC_OUT_OF_RANGE,
+ * even if other frames keep the bus awake. In ticks of systick.h, the
+ * settings may replace it (SYSTICK_NEVER keeps the values).
+ */
+#define PDC_STALE_AGE            SYSTICK_MS(1000)
+
+/**
+ * \brief used number of columns
+ *
+ * This value should match number of columns of matrixbar, but need not
+ * necessarily. In this case it matches.
+ */
+#define NUM_OF_PDC_VALUES_SHOWN  MATRIXBAR_COLUMNS
+
+/**
+ * \brief number of sensor values stored
+ *
+ * By default the rear sensors are combined into left and right. With
+ * PDC_ALL_SENSORS defined, all eight sensors are kept in order of their
+ * position from front left to rear right:
+ *
+ * \code
+ * slot  sensor
+ * 0     front left
+ * 1     front mid left
+ * 2     front mid right
+ * 3     front right
+ * 4     rear left
+ * 5     rear mid left
+ * 6     rear mid right
+ * 7     rear right
+ * \endcode
+ *
+ * Each column shows the nearest of PDC_SENSORS_PER_COLUMN neighbouring
+ * sensors.
+ */
+#ifdef PDC_ALL_SENSORS
+   #define NUM_OF_PDC_SENSORS    8
+#else
+   #define NUM_OF_PDC_SENSORS    2
+#endif
+
+/**
+ * \brief sensors shown in one column
+ */
+#define PDC_SENSORS_PER_COLUMN   (NUM_OF_PDC_SENSORS / NUM_OF_PDC_VALUES_SHOWN)
+
 // === TYPE DEFINITIONS ======================================================
 
 /**
@@ -85,7 +138,9 @@ typedef enum
    //! wake up (AVR and CAN)
    WAKEUP         = 4,
    //! an error occurred, stop working
-   ERROR          = 5
+   ERROR          = 5,
+   //! always the last one
+   NUM_OF_STATES  = 6
 } state_t;
 
 
@@ -168,4 +223,76 @@ void initHardware(void);
  */
 bool initCAN(void);
 
+/**
+ * \brief continue the detection of the bit rates
+ *
+ * Called with each refresh of the display while running. Each controller
+ * is set up by setupCAN(), as soon as its bit rate is known, so a bus
+ * receives while the bit rate of another one is still detected.
+ */
+void probeCAN(void);
+
+/**
+ * \brief set up filters and receive buffers of a controller
+ *
+ * Called, when the bit rate is known. The configuration is copied to be
+ * checked on wake up, see mcp2515_shadow.h.
+ *
+ * \param chip controller
+ */
+void setupCAN(eChipSelect chip);
+
+/**
+ * \brief fill registers of a mask or filter with a standard id
+ *
+ * \code
+ * SIDH -> bits 3..10 of CAN ID @ bits 0..7
+ * SIDL -> bits 0..2  of CAN ID @ bits 5..7
+ * \endcode
+ *
+ * EXIDE of the filters is not set, so only standard frames are accepted.
+ * EID8 and EID0 are cleared: for standard frames they compare the data
+ * bytes 0 and 1, which the masks must not restrict.
+ *
+ * \param regs SIDH, SIDL, EID8 and EID0 of mask or filter to fill
+ * \param id 11bit CAN id or mask
+ */
+void setFilterId(uint8_t* regs, uint16_t id);
+
+/**
+ * \brief set all sensor values to PDC_OUT_OF_RANGE
+ */
+void resetPdcValues(void);
+
+/**
+ * \brief reset the values shown, if PDC is inactive
+ *
+ * Called with each refresh of the display while running.
+ */
+void checkPdcTimeout(void);
+
+/**
+ * \brief reset the values of sensors not decoded for PDC_STALE_AGE
+ *
+ * Called with each refresh of the display while running.
+ */
+void checkStaleValues(void);
+
+/**
+ * \brief show the stored PDC values
+ *
+ * Writes the value of each column into the framebuffer.
+ */
+void updateDisplay(void);
+
+/**
+ * \brief get value shown in a column
+ *
+ * The nearest of the sensors shown in the column.
+ *
+ * \param col column of the matrixbar
+ * \return value to set
+ */
+uint8_t getColumnValue(uint8_t col);
+
 #endif /* PDCVIEWER_H_ */
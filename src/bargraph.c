@@ -0,0 +1,100 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file bargraph.c
+ *
+ * \date Created: 16.10.2026 23:02:06
+ * \author agent
+ **/
+
+
+#include "hal.h"
+#include "util/util.h"
+#include "config/matrixbar_config.h"
+#include "bargraph.h"
+
+// === DEFINITIONS ===========================================================
+
+/**
+ * \brief port of the rows as given in P_MATRIXBAR_ROW
+ */
+typedef struct
+{
+   //! data direction register
+   volatile uint8_t* ddr;
+   //! port register
+   volatile uint8_t* port;
+   //! pins used
+   uint8_t           mask;
+} bargraph_port_t;
+
+//! ports of the rows
+static const bargraph_port_t rows[BARGRAPH_NUM_OF_PORTS] = { P_MATRIXBAR_ROW };
+
+//! option reverse of the lookup table
+#ifdef MATRIXBAR_REVERSE
+   #define BARGRAPH_LUT_REVERSE  true
+#else
+   #define BARGRAPH_LUT_REVERSE  false
+#endif
+
+//! option inverted of the lookup table
+#ifdef MATRIXBAR_INVERTED
+   #define BARGRAPH_LUT_INVERTED true
+#else
+   #define BARGRAPH_LUT_INVERTED false
+#endif
+
+//! value is mirrored before reading the table
+static bool flipReverse  = false;
+
+//! pins read from the table are inverted
+static bool flipInverted = false;
+
+// === FUNCTIONS =============================================================
+
+void bargraph_set_options(bool reverse, bool inverted)
+{
+   flipReverse  = (reverse != BARGRAPH_LUT_REVERSE);
+   flipInverted = (inverted != BARGRAPH_LUT_INVERTED);
+}
+
+void bargraph_pattern(uint8_t value, uint8_t* pins)
+{
+   uint8_t i;
+
+   if(flipReverse)
+   {
+      value = (value < MATRIXBAR_MAX_VALUE) ? (uint8_t)(MATRIXBAR_MAX_VALUE - value) : 0;
+   }
+
+   memcpy_P(pins, bargraphLut[value], BARGRAPH_NUM_OF_PORTS);
+
+   if(flipInverted)
+   {
+      for(i = 0; i < BARGRAPH_NUM_OF_PORTS; ++i)
+      {
+         pins[i] ^= rows[i].mask;
+      }
+   }
+}
+
+void bargraph_write(const uint8_t* pins)
+{
+   uint8_t i;
+
+   for(i = 0; i < BARGRAPH_NUM_OF_PORTS; ++i)
+   {
+      *rows[i].port = (uint8_t)((*rows[i].port & ~rows[i].mask) | pins[i]);
+   }
+}
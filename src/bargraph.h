@@ -0,0 +1,66 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file bargraph.h
+ *
+ * Sets the row pins of the matrixbar by a lookup table, which is generated
+ * from matrixbar_config.h at build time (see bargraph_lut.cmake). Scaling,
+ * MATRIXBAR_REVERSE and MATRIXBAR_INVERTED are resolved in the table, so
+ * showing a value is a read of the table and a write per port.
+ *
+ * Options set at runtime differing from the table are applied to the value
+ * (reverse) and the pins (inverted) read.
+ *
+ * \date Created: 16.10.2026 23:02:06
+ * \author agent
+ **/
+
+
+#ifndef BARGRAPH_H_
+#define BARGRAPH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "bargraph_lut.h"
+
+/**
+ * \brief get row pins showing a value
+ *
+ * Replaces matrixbar_set(). The columns are still handled by the matrixbar
+ * module.
+ *
+ * \param value 0..255, values above MATRIXBAR_MAX_VALUE show like it
+ * \param pins to fill, one byte per port of P_MATRIXBAR_ROW
+ */
+void bargraph_pattern(uint8_t value, uint8_t* pins);
+
+/**
+ * \brief set options at runtime
+ *
+ * Reversing the lookup table mirrors the value at MATRIXBAR_MAX_VALUE / 2,
+ * so the bars may switch one value off from the table built with the
+ * option.
+ *
+ * \param reverse all pins set for the value 0
+ * \param inverted pins are inverted
+ */
+void bargraph_set_options(bool reverse, bool inverted);
+
+/**
+ * \brief set row pins of the matrixbar
+ * \param pins as given by bargraph_pattern()
+ */
+void bargraph_write(const uint8_t* pins);
+
+#endif /* BARGRAPH_H_ */
@@ -0,0 +1,163 @@
+##################################################################################
+#
+# "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+# <dev@layer128.net> wrote this file. As long as you retain this notice you
+# can do whatever you want with this stuff. If we meet some day, and you think
+# this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+# like beer much.)
+#
+# Matthias Kleemann
+#
+##################################################################################
+#
+# Generates the lookup table of the bargraph from matrixbar_config.h. The
+# configuration is run through the preprocessor of the compiler used, so all
+# definitions of the build are taken into account.
+#
+# cmake -DCC=<compiler> -DCONFIG=<matrixbar_config.h> -DDEFS=<a|b=1>
+#       -DOUTPUT=<dir> -P bargraph_lut.cmake
+#
+# Writes bargraph_lut.h and bargraph_lut.c to the output directory.
+#
+##################################################################################
+
+string(REPLACE "|" ";" defs "${DEFS}")
+
+set(cc_defs "")
+foreach(def ${defs})
+   list(APPEND cc_defs "-D${def}")
+endforeach(def)
+
+execute_process(
+   COMMAND ${CC} ${cc_defs} -E -dM -x c ${CONFIG}
+   OUTPUT_VARIABLE macros
+   RESULT_VARIABLE result
+)
+
+if(NOT result EQUAL 0)
+   message(FATAL_ERROR "cannot preprocess ${CONFIG}")
+endif(NOT result EQUAL 0)
+
+##################################################################################
+# parameters
+##################################################################################
+string(REGEX MATCH "#define MATRIXBAR_MAX_VALUE ([0-9]+)" match "${macros}")
+if(NOT match)
+   message(FATAL_ERROR "MATRIXBAR_MAX_VALUE not found in ${CONFIG}")
+endif(NOT match)
+set(max_value ${CMAKE_MATCH_1})
+
+string(REGEX MATCH "#define MATRIXBAR_REVERSE" reverse "${macros}")
+string(REGEX MATCH "#define MATRIXBAR_INVERTED" inverted "${macros}")
+
+string(REGEX MATCH "#define P_MATRIXBAR_ROW ([^\n]*)" match "${macros}")
+if(NOT match)
+   message(FATAL_ERROR "P_MATRIXBAR_ROW not found in ${CONFIG}")
+endif(NOT match)
+
+# masks are the last member of each port entry
+string(REGEX MATCHALL "(0x[0-9A-Fa-f]+|[0-9]+)[ ]*}" entries "${CMAKE_MATCH_1}")
+
+set(masks "")
+set(num_of_pins 0)
+foreach(entry ${entries})
+   string(REGEX REPLACE "[ ]*}" "" mask "${entry}")
+   math(EXPR mask "${mask}")
+   list(APPEND masks ${mask})
+   foreach(bit RANGE 7)
+      math(EXPR set "(${mask} >> ${bit}) & 1")
+      if(set)
+         math(EXPR num_of_pins "${num_of_pins} + 1")
+      endif(set)
+   endforeach(bit)
+endforeach(entry)
+list(LENGTH masks num_of_ports)
+
+##################################################################################
+# table
+##################################################################################
+math(EXPR range "${num_of_pins} + 1")
+math(EXPR all_pins "(1 << ${num_of_pins}) - 1")
+
+set(table "")
+foreach(value RANGE 255)
+   # 0..MATRIXBAR_MAX_VALUE -> 0..number of pins lit
+   set(clamped ${value})
+   if(clamped GREATER max_value)
+      set(clamped ${max_value})
+   endif(clamped GREATER max_value)
+   math(EXPR level "${clamped} * ${range} / (${max_value} + 1)")
+   if(reverse)
+      math(EXPR level "${num_of_pins} - ${level}")
+   endif(reverse)
+   math(EXPR bar "(1 << ${level}) - 1")
+   if(inverted)
+      math(EXPR bar "~${bar} & ${all_pins}")
+   endif(inverted)
+
+   # distribute bar to the pins of the ports, LSB first
+   set(row "")
+   foreach(mask ${masks})
+      set(out 0)
+      foreach(bit RANGE 7)
+         math(EXPR set "(${mask} >> ${bit}) & 1")
+         if(set)
+            math(EXPR out "${out} | ((${bar} & 1) << ${bit})")
+            math(EXPR bar "${bar} >> 1")
+         endif(set)
+      endforeach(bit)
+      math(EXPR hi "${out} >> 4")
+      math(EXPR lo "${out} & 15")
+      string(SUBSTRING "0123456789ABCDEF" ${hi} 1 hi)
+      string(SUBSTRING "0123456789ABCDEF" ${lo} 1 lo)
+      set(row "${row} 0x${hi}${lo},")
+   endforeach(mask)
+   string(REGEX REPLACE ",$" "" row "${row}")
+   set(table "${table}   {${row} }, // ${value}\n")
+endforeach(value)
+string(REGEX REPLACE ",( // 255\n)$" " \\1" table "${table}")
+
+##################################################################################
+# header and table
+##################################################################################
+file(WRITE ${OUTPUT}/bargraph_lut.h
+"/**
+ * \\file bargraph_lut.h
+ *
+ * Generated by bargraph_lut.cmake from matrixbar_config.h - do not edit.
+ *
+ * ${num_of_pins} row pins on ${num_of_ports} port(s), MATRIXBAR_MAX_VALUE ${max_value}
+ **/
+
+
+#ifndef BARGRAPH_LUT_H_
+#define BARGRAPH_LUT_H_
+
+#include <stdint.h>
+
+//! number of ports in P_MATRIXBAR_ROW
+#define BARGRAPH_NUM_OF_PORTS    ${num_of_ports}
+
+/**
+ * \\brief row pins to set for a value, per port of P_MATRIXBAR_ROW
+ */
+extern const uint8_t bargraphLut[256][BARGRAPH_NUM_OF_PORTS];
+
+#endif /* BARGRAPH_LUT_H_ */
+")
+
+file(WRITE ${OUTPUT}/bargraph_lut.c
+"/**
+ * \\file bargraph_lut.c
+ *
+ * Generated by bargraph_lut.cmake from matrixbar_config.h - do not edit.
+ **/
+
+
+#include \"hal.h\"
+#include \"bargraph_lut.h\"
+
+const uint8_t bargraphLut[256][BARGRAPH_NUM_OF_PORTS] PROGMEM =
+{
+${table}};
+")
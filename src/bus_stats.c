@@ -0,0 +1,357 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file bus_stats.c
+ *
+ * \date Created: 16.10.2026 23:42:31
+ * \author agent
+ **/
+
+
+#include <string.h>
+
+#include "hal.h"
+#include "debug.h"
+#include "can_autobaud.h"
+#include "can_fifo.h"
+#include "can_rx.h"
+#include "mcp2515_burst.h"
+#include "bus_stats.h"
+
+#ifdef BUS_STATS
+
+// === DEFINITIONS ===========================================================
+
+//! lines dumped per controller
+#define BUS_STATS_CHIP_LINES     5
+
+// === TYPE DEFINITIONS ======================================================
+
+/**
+ * \brief statistics of a controller
+ */
+typedef struct
+{
+   //! frames of the window running per bucket (written by the ISR)
+   uint16_t count[BUS_STATS_BUCKETS];
+   //! frames of the last window per bucket
+   uint16_t rate[BUS_STATS_BUCKETS];
+   //! maximum frames of a window per bucket
+   uint16_t peak[BUS_STATS_BUCKETS];
+   //! polls finding a message error (saturating)
+   uint16_t errors;
+   //! transmit error counter polled last
+   uint8_t  tec;
+   //! receive error counter polled last
+   uint8_t  rec;
+   //! maximum transmit error counter
+   uint8_t  tecMax;
+   //! maximum receive error counter
+   uint8_t  recMax;
+} bus_stats_chip_t;
+
+// === GLOBALS ===============================================================
+
+//! statistics of all controllers
+static bus_stats_chip_t chips[NUM_OF_MCP2515];
+
+//! frames decoded
+static uint32_t framesDecoded = 0;
+
+//! frames rejected by pdc_decode()
+static uint32_t framesRejected = 0;
+
+//! CAN id of the PDC message
+static uint16_t pdcId = 0;
+
+//! time the PDC message was received last
+static uint16_t pdcLast = 0;
+
+//! a PDC message was received since waking up
+static bool pdcSeen = false;
+
+//! maximum gap between two PDC messages in ticks
+static uint16_t pdcGapMax = 0;
+
+//! start of the window running
+static uint16_t windowStart = 0;
+
+//! names of the lines
+static const char lineFrames[] PROGMEM = "  frames/s    ";
+static const char linePeak[]   PROGMEM = "  peak/s      ";
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief close the window running
+ */
+static void bus_stats_window(void)
+{
+   bus_stats_chip_t* c;
+   uint8_t           i;
+   uint8_t           state;
+
+   for(c = chips; c < &chips[NUM_OF_MCP2515]; ++c)
+   {
+      // the ISR counts the next window meanwhile
+      state = hal_irq_save();
+      memcpy(c->rate, c->count, sizeof(c->rate));
+      memset(c->count, 0, sizeof(c->count));
+      hal_irq_restore(state);
+
+      for(i = 0; i < BUS_STATS_BUCKETS; ++i)
+      {
+         if(c->rate[i] > c->peak[i])
+         {
+            c->peak[i] = c->rate[i];
+         }
+      }
+   }
+}
+
+/**
+ * \brief poll error counters and flags of the controllers
+ *
+ * The SPI is shared with ISR(INT0_vect), so INT0 is disabled meanwhile.
+ * Controllers detecting the bitrate are skipped, their message errors
+ * reject a bitrate (see can_autobaud.h).
+ */
+static void bus_stats_errors(void)
+{
+   bus_stats_chip_t* c = chips;
+   uint8_t           regs[2];
+   uint8_t           chip;
+
+   hal_can_irq_disable();
+   for(chip = 0; chip < NUM_OF_MCP2515; ++chip, ++c)
+   {
+      if(can_autobaud_busy((eChipSelect)chip))
+      {
+         continue;
+      }
+
+      // TEC and REC are consecutive
+      mcp2515_read_burst((eChipSelect)chip, TEC, regs, sizeof(regs));
+      c->tec = regs[0];
+      c->rec = regs[1];
+      if(c->tec > c->tecMax)
+      {
+         c->tecMax = c->tec;
+      }
+      if(c->rec > c->recMax)
+      {
+         c->recMax = c->rec;
+      }
+
+      // the message error interrupt is not enabled, the flag is polled
+      if(read_register_mcp2515((eChipSelect)chip, CANINTF) & (1 << MERRF))
+      {
+         bit_modify_mcp2515((eChipSelect)chip, CANINTF, (1 << MERRF), 0);
+         if(UINT16_MAX != c->errors)
+         {
+            ++c->errors;
+         }
+      }
+   }
+   hal_can_irq_enable();
+}
+
+/**
+ * \brief dump counters of all buckets
+ * \param name of the line
+ * \param counts per bucket
+ */
+static void bus_stats_dump_buckets(const char* name, const uint16_t* counts)
+{
+   uint8_t i;
+
+   debug_puts_P(name);
+   for(i = 0; i < BUS_STATS_BUCKETS; ++i)
+   {
+      debug_put_dec(counts[i], 6);
+   }
+   debug_newline();
+}
+
+// === FUNCTIONS =============================================================
+
+void bus_stats_init(uint16_t id)
+{
+   pdcId       = id;
+   windowStart = systick_now();
+   debug_init();
+}
+
+void bus_stats_frame(eChipSelect chip, const can_t* msg)
+{
+   uint16_t now;
+
+   ++chips[chip].count[(msg->msgId >> BUS_STATS_BUCKET_SHIFT) & (BUS_STATS_BUCKETS - 1)];
+
+   if(pdcId == msg->msgId)
+   {
+      now = systick_now();
+      if(pdcSeen && ((uint16_t)(now - pdcLast) > pdcGapMax) &&
+         ((uint16_t)(now - pdcLast) < BUS_STATS_PAUSE))
+      {
+         pdcGapMax = (uint16_t)(now - pdcLast);
+      }
+      pdcLast = now;
+      pdcSeen = true;
+   }
+}
+
+void bus_stats_decoded(bool decoded)
+{
+   if(decoded)
+   {
+      ++framesDecoded;
+   }
+   else
+   {
+      ++framesRejected;
+   }
+}
+
+void bus_stats_wake(void)
+{
+   bus_stats_chip_t* c;
+
+   for(c = chips; c < &chips[NUM_OF_MCP2515]; ++c)
+   {
+      memset(c->count, 0, sizeof(c->count));
+   }
+   // INT0 is disabled while waking up
+   pdcSeen     = false;
+   windowStart = systick_now();
+}
+
+void bus_stats_poll(void)
+{
+   uint8_t state;
+
+   // a pause, the time wraps around before the next frame otherwise
+   state = hal_irq_save();
+   if(pdcSeen && (systick_since(pdcLast) >= BUS_STATS_PAUSE))
+   {
+      pdcSeen = false;
+   }
+   hal_irq_restore(state);
+
+   if(systick_since(windowStart) >= BUS_STATS_WINDOW)
+   {
+      windowStart += BUS_STATS_WINDOW;
+      bus_stats_window();
+      bus_stats_errors();
+   }
+}
+
+bool bus_stats_dump_line(uint8_t line)
+{
+   bus_stats_chip_t* c;
+   eChipSelect       chip;
+   uint16_t          gap;
+   uint8_t           state;
+
+   if(line >= (NUM_OF_MCP2515 * BUS_STATS_CHIP_LINES))
+   {
+      if((NUM_OF_MCP2515 * BUS_STATS_CHIP_LINES) == line)
+      {
+         debug_puts_P(PSTR("frames decoded "));
+         debug_put_dec(framesDecoded, 1);
+         debug_puts_P(PSTR(", rejected "));
+         debug_put_dec(framesRejected, 1);
+         debug_newline();
+         return true;
+      }
+
+      // written by the ISR
+      state = hal_irq_save();
+      gap   = pdcGapMax;
+      hal_irq_restore(state);
+
+      debug_puts_P(PSTR("PDC gap max "));
+      // ticks of 1024 cycles, not in the hot path
+      debug_put_dec((uint32_t)gap * 1024UL / (F_CPU / 1000UL), 1);
+      debug_puts_P(PSTR(" ms"));
+      debug_newline();
+      return false;
+   }
+
+   chip = (eChipSelect)(line / BUS_STATS_CHIP_LINES);
+   c    = &chips[chip];
+   switch(line % BUS_STATS_CHIP_LINES)
+   {
+      case 0:
+      {
+         debug_puts_P(PSTR("bus "));
+         debug_put_dec(chip + 1, 1);
+         debug_puts_P(PSTR("          0x000 0x100 0x200 0x300 0x400 0x500 0x600 0x700"));
+         debug_newline();
+         break;
+      }
+
+      case 1:
+      {
+         bus_stats_dump_buckets(lineFrames, c->rate);
+         break;
+      }
+
+      case 2:
+      {
+         bus_stats_dump_buckets(linePeak, c->peak);
+         break;
+      }
+
+      case 3:
+      {
+         debug_puts_P(PSTR("  TEC "));
+         debug_put_dec(c->tec, 1);
+         debug_puts_P(PSTR(" (max "));
+         debug_put_dec(c->tecMax, 1);
+         debug_puts_P(PSTR("), REC "));
+         debug_put_dec(c->rec, 1);
+         debug_puts_P(PSTR(" (max "));
+         debug_put_dec(c->recMax, 1);
+         debug_puts_P(PSTR("), message errors "));
+         debug_put_dec(c->errors, 1);
+         debug_newline();
+         break;
+      }
+
+      default:
+      {
+         debug_puts_P(PSTR("  overflows "));
+         debug_put_dec(mcp2515_rx_overflows(chip, 0), 1);
+         debug_puts_P(PSTR(" (RXB0), "));
+         debug_put_dec(mcp2515_rx_overflows(chip, 1), 1);
+         debug_puts_P(PSTR(" (RXB1), dropped "));
+         debug_put_dec(can_rx_dropped(chip), 1);
+         debug_puts_P(PSTR(" (FIFO)"));
+         debug_newline();
+         break;
+      }
+   }
+   return true;
+}
+
+void bus_stats_dump(void)
+{
+   uint8_t line = 0;
+
+   while(bus_stats_dump_line(line++))
+   {
+   }
+}
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file bus_stats.h
+ *
+ * Statistics of the buses, to tell missed PDC updates caused by bus load,
+ * filters or receive buffer overflows apart:
+ *
+ * * frames per second by id bucket (id >> 8) and controller, the last
+ *   second and the peak
+ * * frames decoded vs. frames passing the masks of the MCP2515, but
+ *   rejected by pdc_decode()
+ * * receive buffer overflows and frames dropped by the FIFO
+ * * TEC/REC and message errors (MERRF) polled from each MCP2515
+ * * maximum gap between two PDC frames, pauses of BUS_STATS_PAUSE or
+ *   longer (e.g. reverse gear left) are not counted
+ *
+ * Each frame costs an increment and a compare, no division. The seconds are
+ * counted by the tick of the main loop, where the error counters are polled
+ * via SPI as well. The block is dumped via the debug channel on request,
+ * one line per tick (see debug_poll()).
+ *
+ * Frames rejected by the filters of the MCP2515 never reach the AVR, so
+ * they are not counted. In listen only mode the MCP2515 keeps TEC and REC
+ * at 0, the message errors show a wrong bitrate or a disturbed bus then.
+ * Controllers still detecting the bitrate are not polled, the errors of
+ * the bitrates probed are not counted.
+ *
+ * Only active, if BUS_STATS is defined (cmake -DWITH_BUS_STATS=ON).
+ * Otherwise all macros are empty.
+ *
+ * \date Created: 16.10.2026 23:42:31
+ * \author agent
+ **/
+
+
+#ifndef BUS_STATS_H_
+#define BUS_STATS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "can/can_mcp2515.h"
+#include "systick.h"
+
+// === DEFINITIONS ===========================================================
+
+//! number of id buckets (0x000..0x0FF, 0x100..0x1FF, ...)
+#define BUS_STATS_BUCKETS        8
+
+//! bits of the id not telling the bucket
+#define BUS_STATS_BUCKET_SHIFT   8
+
+//! length of a window counting frames (see systick.h)
+#define BUS_STATS_WINDOW         SYSTICK_MS(1000)
+
+//! PDC frames missing as long are a pause, not a gap
+#define BUS_STATS_PAUSE          SYSTICK_MS(10000)
+
+#ifdef BUS_STATS
+
+// === FUNCTIONS =============================================================
+
+/**
+ * \brief initialize statistics and debug channel
+ * \param id CAN id of the PDC message, whose gaps are measured
+ */
+void bus_stats_init(uint16_t id);
+
+/**
+ * \brief count a frame read from a controller (ISR)
+ * \param chip controller
+ * \param msg frame
+ */
+void bus_stats_frame(eChipSelect chip, const can_t* msg);
+
+/**
+ * \brief count a frame processed by the main loop
+ * \param decoded true, if pdc_decode() took values from it
+ */
+void bus_stats_decoded(bool decoded);
+
+/**
+ * \brief start over after waking up
+ *
+ * The time asleep is neither a gap between PDC frames nor part of a window.
+ */
+void bus_stats_wake(void);
+
+/**
+ * \brief close the window each second and poll the controllers (main
+ *        loop, each tick)
+ */
+void bus_stats_poll(void);
+
+/**
+ * \brief dump a line of the block via debug channel
+ * \param line 0 for the first one
+ * \return true, if more lines follow
+ */
+bool bus_stats_dump_line(uint8_t line);
+
+/**
+ * \brief dump the block via debug channel at once
+ */
+void bus_stats_dump(void);
+
+#else
+
+#define bus_stats_init(id)             ((void)(id))
+#define bus_stats_frame(chip, msg)     ((void)(msg))
+#define bus_stats_decoded(decoded)
+#define bus_stats_wake()
+#define bus_stats_poll()
+#define bus_stats_dump_line(line)      ((void)(line), false)
+#define bus_stats_dump()
+
+#endif
+
+#endif /* BUS_STATS_H_ */
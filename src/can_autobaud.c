@@ -0,0 +1,200 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file can_autobaud.c
+ *
+ * \date Created: 16.10.2026 23:21:29
+ * \author agent
+ **/
+
+
+#include "hal.h"
+#include "mcp2515_burst.h"
+#include "config_store.h"
+#include "systick.h"
+#include "can_rx.h"
+#include "can_autobaud.h"
+
+// === DEFINITIONS ===========================================================
+
+//! number of bit timing registers (CNF3, CNF2, CNF1)
+#define AUTOBAUD_NUM_OF_CNF      3
+
+//! bitrates listened to at most
+#define AUTOBAUD_NUM_OF_PROBES   (CAN_AUTOBAUD_ROUNDS * NUM_OF_CAN_BITRATES)
+
+//! each controller needs a bitrate in the settings
+typedef char can_autobaud_bus_check[(NUM_OF_MCP2515 <= CONFIG_NUM_OF_BUSES) ? 1 : -1];
+
+// === TYPE DEFINITIONS ======================================================
+
+/**
+ * \brief state of the detection of a controller
+ */
+typedef struct
+{
+   //! bitrate to start with, set again if nothing is locked
+   eCanBitRate first;
+   //! time listening at the bitrate set started, see systick.h
+   uint16_t    since;
+   //! frames read by the receive scheduler before, see can_rx_frames()
+   uint16_t    frames;
+   //! listening, until done
+   bool        busy;
+} can_autobaud_probe_t;
+
+// === GLOBALS ===============================================================
+
+//! result of the last detection per controller
+static can_autobaud_t results[NUM_OF_MCP2515];
+
+//! state of the detection per controller
+static can_autobaud_probe_t probes[NUM_OF_MCP2515];
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief set another bitrate
+ *
+ * Only the bit timing is written in configuration mode, no reset needed.
+ * Flags of the last bitrate are cleared.
+ *
+ * \param chip controller
+ * \param bitrate to set
+ */
+static void can_autobaud_set(eChipSelect chip, eCanBitRate bitrate)
+{
+   const uint8_t* cnf = getCanConfiguration(bitrate);
+   uint8_t        regs[AUTOBAUD_NUM_OF_CNF];
+
+   regs[0] = cnf[2];
+   regs[1] = cnf[1];
+   regs[2] = cnf[0];
+
+   set_mode_mcp2515(chip, CONFIG_MODE);
+   mcp2515_write_burst(chip, CNF3, regs, AUTOBAUD_NUM_OF_CNF);
+   write_register_mcp2515(chip, CANINTF, 0);
+   set_mode_mcp2515(chip, LISTEN_ONLY_MODE);
+}
+
+/**
+ * \brief finish the detection
+ *
+ * A bitrate locked and not cached yet is set to be saved to the EEPROM.
+ *
+ * \param chip controller
+ */
+static void can_autobaud_done(eChipSelect chip)
+{
+   can_autobaud_t* result = &results[chip];
+   config_t        settings;
+
+   if(!result->locked && (result->bitrate != probes[chip].first))
+   {
+      result->bitrate = probes[chip].first;
+      can_autobaud_set(chip, result->bitrate);
+   }
+
+   if(result->locked && (!result->cached || (result->bitrate != probes[chip].first)))
+   {
+      settings               = *config_get();
+      settings.bitrate[chip] = (uint8_t)result->bitrate;
+      config_set(&settings);
+   }
+
+   // frames received are left to the receive scheduler
+   bit_modify_mcp2515(chip, CANINTF, (1 << MERRF), 0);
+   probes[chip].busy = false;
+}
+
+// === FUNCTIONS =============================================================
+
+eCanBitRate can_autobaud_start(eChipSelect chip)
+{
+   can_autobaud_t* result  = &results[chip];
+   uint8_t         bitrate = config_get()->bitrate[chip];
+
+   result->cached  = (bitrate < NUM_OF_CAN_BITRATES);
+   result->bitrate = result->cached ? (eCanBitRate)bitrate : CAN_AUTOBAUD_DEFAULT;
+   result->probes  = 0;
+   result->locked  = false;
+
+   return result->bitrate;
+}
+
+void can_autobaud_begin(eChipSelect chip)
+{
+   write_register_mcp2515(chip, CANINTF, 0);
+
+   probes[chip].first   = results[chip].bitrate;
+   probes[chip].since   = systick_now();
+   probes[chip].frames  = can_rx_frames(chip);
+   probes[chip].busy    = true;
+   results[chip].probes = 1;
+}
+
+bool can_autobaud(eChipSelect chip)
+{
+   can_autobaud_t* result = &results[chip];
+   uint8_t         flags  = read_register_mcp2515(chip, CANINTF);
+   bool            silent;
+
+   // read by ISR(INT0_vect) meanwhile or still pending
+   if((can_rx_frames(chip) != probes[chip].frames) || (flags & ((1 << RX0IF) | (1 << RX1IF))))
+   {
+      result->locked = true;
+      can_autobaud_done(chip);
+      return true;
+   }
+
+   silent = ((uint16_t)(systick_now() - probes[chip].since) >= SYSTICK_MS(CAN_AUTOBAUD_LISTEN_MS));
+   if(!(flags & (1 << MERRF)) && !silent)
+   {
+      // keep listening
+      return false;
+   }
+
+   // a silent bus doesn't tell anything against the cached bitrate
+   if((1 == result->probes) && result->cached && !(flags & (1 << MERRF)))
+   {
+      can_autobaud_done(chip);
+      return true;
+   }
+
+   // next bitrate of the table, including the first one each round
+   if(result->probes >= AUTOBAUD_NUM_OF_PROBES)
+   {
+      can_autobaud_done(chip);
+      return true;
+   }
+   result->bitrate = (eCanBitRate)((probes[chip].first + result->probes) % NUM_OF_CAN_BITRATES);
+   ++result->probes;
+   can_autobaud_set(chip, result->bitrate);
+   probes[chip].since = systick_now();
+   return false;
+}
+
+void can_autobaud_stop(eChipSelect chip)
+{
+   can_autobaud_done(chip);
+}
+
+bool can_autobaud_busy(eChipSelect chip)
+{
+   return probes[chip].busy;
+}
+
+const can_autobaud_t* can_autobaud_result(eChipSelect chip)
+{
+   return &results[chip];
+}
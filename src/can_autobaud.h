@@ -0,0 +1,142 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file can_autobaud.h
+ *
+ * Detection of the bitrate of the bus. The MCP2515 listens (listen only
+ * mode, no acknowledge or error frames sent) at each bitrate of the
+ * mcp2515_cnf table. A frame received locks the bitrate, a message error
+ * (MERRF) rejects it at once. A bus without traffic keeps the bitrate to
+ * be listened to for CAN_AUTOBAUD_LISTEN_MS.
+ *
+ * The detection doesn't block: can_autobaud() is called with each tick of
+ * the main loop and checks the interrupt flags once, so the controllers
+ * with a bitrate known receive while the others are still listening.
+ * Frames received meanwhile are read by the receive scheduler (see
+ * can_rx.h) and lock the bitrate as well.
+ *
+ * The bitrate locked is cached in the EEPROM (see config_store.h) and
+ * listened to first on the next boot. Unless it is rejected by an error,
+ * the table is not scanned then. Each controller detects and caches the
+ * bitrate of its own bus.
+ *
+ * \date Created: 16.10.2026 23:21:29
+ * \author agent
+ **/
+
+
+#ifndef CAN_AUTOBAUD_H_
+#define CAN_AUTOBAUD_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "can/can_mcp2515.h"
+
+// === DEFINITIONS ===========================================================
+
+//! bitrate used, if nothing is cached and no frame is received
+#define CAN_AUTOBAUD_DEFAULT     CAN_BITRATE_100_KBPS
+
+//! time to listen at each bitrate in ms (two periods of the PDC frames)
+#define CAN_AUTOBAUD_LISTEN_MS   200
+
+//! passes through the table before giving up
+#define CAN_AUTOBAUD_ROUNDS      2
+
+// === TYPE DEFINITIONS ======================================================
+
+/**
+ * \brief result of the detection
+ */
+typedef struct
+{
+   //! bitrate set
+   eCanBitRate bitrate;
+   //! bitrates listened to
+   uint8_t     probes;
+   //! a frame was received at the bitrate (else cached or default)
+   bool        locked;
+   //! bitrate was read from the EEPROM
+   bool        cached;
+} can_autobaud_t;
+
+// === FUNCTIONS =============================================================
+
+/**
+ * \brief get bitrate to start with
+ *
+ * The settings need to be loaded before.
+ *
+ * \param chip controller
+ * \return bitrate cached in the EEPROM or CAN_AUTOBAUD_DEFAULT
+ */
+eCanBitRate can_autobaud_start(eChipSelect chip);
+
+/**
+ * \brief start listening to the bus
+ *
+ * The controller needs to be initialized with the bitrate returned by
+ * can_autobaud_start() of the chip and in listen only mode. The receive
+ * interrupts stay enabled, so no frame waits for the detection.
+ *
+ * \param chip controller
+ */
+void can_autobaud_begin(eChipSelect chip);
+
+/**
+ * \brief continue the detection of the bitrate
+ *
+ * Checks the interrupt flags of the controller once and sets the next
+ * bitrate, if the one set is rejected or silent for CAN_AUTOBAUD_LISTEN_MS.
+ * Uses the SPI, so INT0 needs to be disabled by the caller.
+ *
+ * When done, the controller is left in listen only mode with the message
+ * error flag cleared. A bitrate locked and not cached yet is set to be
+ * saved to the EEPROM. Without any frame after
+ * CAN_AUTOBAUD_ROUNDS passes through the table, the bitrate of
+ * can_autobaud_start() is set again.
+ *
+ * \param chip controller
+ * \return true, if done
+ */
+bool can_autobaud(eChipSelect chip);
+
+/**
+ * \brief give up the detection, e.g. before sleeping
+ *
+ * The bitrate of can_autobaud_start() is set again, unless locked. The
+ * controller is left as by can_autobaud() when done.
+ *
+ * \param chip controller
+ */
+void can_autobaud_stop(eChipSelect chip);
+
+/**
+ * \brief check if the detection is running
+ *
+ * The message error flag (MERRF) belongs to the detection meanwhile.
+ *
+ * \param chip controller
+ * \return true from can_autobaud_begin() until done or stopped
+ */
+bool can_autobaud_busy(eChipSelect chip);
+
+/**
+ * \brief get result of the last detection
+ * \param chip controller
+ * \return result
+ */
+const can_autobaud_t* can_autobaud_result(eChipSelect chip);
+
+#endif /* CAN_AUTOBAUD_H_ */
@@ -0,0 +1,125 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file can_fifo.c
+ *
+ * \date Created: 16.10.2026 22:47:47
+ * \author agent
+ **/
+
+
+#include "hal.h"
+#include "can_fifo.h"
+
+// === GLOBALS ===============================================================
+
+//! index mask
+#define CAN_FIFO_MASK            (CAN_FIFO_SIZE - 1)
+
+//! frame slots
+static can_t canFifo[CAN_FIFO_SIZE];
+
+/**
+ * \brief write index, only changed by the producer
+ *
+ * Both indices are free running. A single byte is accessed atomically on
+ * the AVR, so no locking is needed.
+ */
+static volatile uint8_t canFifoHead       = 0;
+
+//! read index, only changed by the consumer
+static volatile uint8_t canFifoTail       = 0;
+
+//! dropped frames, only changed by the producer
+static volatile uint16_t canFifoDropped   = 0;
+
+//! maximum fill level, only changed by the producer
+static volatile uint8_t canFifoHighWater  = 0;
+
+// === PRODUCER (ISR) ========================================================
+
+can_t* can_fifo_claim(void)
+{
+   uint8_t head = canFifoHead;
+
+   if(CAN_FIFO_SIZE == (uint8_t)(head - canFifoTail))
+   {
+      return NULL;
+   }
+   return &canFifo[head & CAN_FIFO_MASK];
+}
+
+void can_fifo_commit(void)
+{
+   uint8_t head  = canFifoHead + 1;
+   uint8_t level = head - canFifoTail;
+
+   if(level > canFifoHighWater)
+   {
+      canFifoHighWater = level;
+   }
+   // slot is written completely, publish it now
+   canFifoHead = head;
+}
+
+void can_fifo_drop(void)
+{
+   if(UINT16_MAX != canFifoDropped)
+   {
+      ++canFifoDropped;
+   }
+}
+
+// === CONSUMER (MAIN) =======================================================
+
+const can_t* can_fifo_peek(void)
+{
+   uint8_t tail = canFifoTail;
+
+   if(tail == canFifoHead)
+   {
+      return NULL;
+   }
+   return &canFifo[tail & CAN_FIFO_MASK];
+}
+
+void can_fifo_release(void)
+{
+   // slot is not used anymore, give it back to the producer
+   canFifoTail = canFifoTail + 1;
+}
+
+void can_fifo_flush(void)
+{
+   canFifoTail = canFifoHead;
+}
+
+// === STATISTICS ============================================================
+
+uint16_t can_fifo_dropped(void)
+{
+   uint16_t dropped;
+   uint8_t  state;
+
+   // 16bit value written by the ISR
+   state   = hal_irq_save();
+   dropped = canFifoDropped;
+   hal_irq_restore(state);
+
+   return dropped;
+}
+
+uint8_t can_fifo_high_water(void)
+{
+   return canFifoHighWater;
+}
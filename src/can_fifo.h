@@ -0,0 +1,94 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file can_fifo.h
+ *
+ * Lock-free single-producer/single-consumer ring buffer for CAN frames.
+ * The producer is the INT0 interrupt service routine, the consumer is the
+ * main loop. Both work directly on the slots, so no frame is copied.
+ *
+ * \date Created: 16.10.2026 22:47:47
+ * \author agent
+ **/
+
+
+#ifndef CAN_FIFO_H_
+#define CAN_FIFO_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "can/can_mcp2515.h"
+
+// === DEFINITIONS ===========================================================
+
+/**
+ * \brief number of frames buffered
+ *
+ * Needs to be 2^n and not larger than 128, since the free running 8bit
+ * indices are used to distinguish between full and empty.
+ */
+#define CAN_FIFO_SIZE            8
+
+// === PRODUCER (ISR) ========================================================
+
+/**
+ * \brief get free slot to receive a frame into
+ * \return pointer to slot or NULL, if buffer is full
+ */
+can_t* can_fifo_claim(void);
+
+/**
+ * \brief publish the frame received into the claimed slot
+ */
+void can_fifo_commit(void);
+
+/**
+ * \brief count a frame which did not fit into the buffer
+ */
+void can_fifo_drop(void);
+
+// === CONSUMER (MAIN) =======================================================
+
+/**
+ * \brief get oldest frame
+ * \return pointer to frame or NULL, if buffer is empty
+ */
+const can_t* can_fifo_peek(void);
+
+/**
+ * \brief release the oldest frame after processing it
+ */
+void can_fifo_release(void);
+
+/**
+ * \brief discard all frames (consumer side)
+ */
+void can_fifo_flush(void);
+
+// === STATISTICS ============================================================
+
+/**
+ * \brief get number of dropped frames
+ * \return frames dropped since start (saturating)
+ */
+uint16_t can_fifo_dropped(void);
+
+/**
+ * \brief get maximum fill level
+ * \return maximum number of frames in buffer since start
+ */
+uint8_t can_fifo_high_water(void);
+
+#endif /* CAN_FIFO_H_ */
@@ -0,0 +1,181 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file can_rx.c
+ *
+ * \date Created: 16.10.2026 23:39:44
+ * \author agent
+ **/
+
+
+#include "hal.h"
+#include "bus_stats.h"
+#include "can_fifo.h"
+#include "can_rx.h"
+#include "recorder.h"
+
+// === DEFINITIONS ===========================================================
+
+//! both receive buffers full
+#define CAN_RX_FULL              (MCP2515_RXB0_FULL | MCP2515_RXB1_FULL)
+
+//! one bit per controller is used for masks
+typedef char can_rx_chip_check[(NUM_OF_MCP2515 <= 8) ? 1 : -1];
+
+// === GLOBALS ===============================================================
+
+//! controller served first on the next pass, if priorities are equal
+static uint8_t first = 0;
+
+//! frames read per controller
+static uint16_t frames[NUM_OF_MCP2515];
+
+//! frames dropped per controller
+static uint16_t dropped[NUM_OF_MCP2515];
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief read receive buffers of a controller into the FIFO
+ *
+ * RXB0 is read first, since it holds the older frame in case of a rollover.
+ *
+ * \param chip controller
+ * \param pending result of RX STATUS
+ * \return true, if frames were put into the FIFO
+ */
+static bool can_rx_read(eChipSelect chip, uint8_t pending)
+{
+   static can_t discard;
+   can_t*       msg;
+   bool         queued = false;
+   uint8_t      buffer;
+
+   for(buffer = 0; buffer < CAN_RX_BURST; ++buffer)
+   {
+      if(pending & (MCP2515_RXB0_FULL << buffer))
+      {
+         msg = can_fifo_claim();
+         mcp2515_read_rx_buffer(chip, buffer, (NULL != msg) ? msg : &discard);
+         hal_trace_rx((NULL != msg) ? msg : &discard);
+         bus_stats_frame(chip, (NULL != msg) ? msg : &discard);
+         recorder_event(RECORDER_FRAME, (uint16_t)((NULL != msg) ? msg : &discard)->msgId);
+         ++frames[chip];
+
+         if(NULL != msg)
+         {
+            can_fifo_commit();
+            queued = true;
+         }
+         else
+         {
+            can_fifo_drop();
+            ++dropped[chip];
+         }
+      }
+   }
+   return queued;
+}
+
+/**
+ * \brief get 16bit counter written by the ISR
+ * \param counter to read
+ * \return value
+ */
+static uint16_t can_rx_count(const uint16_t* counter)
+{
+   uint16_t count;
+   uint8_t  state;
+
+   state = hal_irq_save();
+   count = *counter;
+   hal_irq_restore(state);
+
+   return count;
+}
+
+// === FUNCTIONS =============================================================
+
+bool can_rx_service(void)
+{
+   uint8_t pending[NUM_OF_MCP2515];
+   uint8_t idle   = 0;
+   bool    busy   = true;
+   bool    queued = false;
+   uint8_t chip;
+   uint8_t full;
+   uint8_t i;
+
+   while(busy)
+   {
+      busy = false;
+      full = 0;
+
+      // INT pins first, the SPI is used for the controllers pending only
+      for(chip = 0; chip < NUM_OF_MCP2515; ++chip)
+      {
+         pending[chip] = 0;
+         if((idle & (1 << chip)) || !can_check_message_received((eChipSelect)chip))
+         {
+            continue;
+         }
+
+         pending[chip] = mcp2515_rx_status((eChipSelect)chip);
+         if(CAN_RX_FULL == pending[chip])
+         {
+            full |= (uint8_t)(1 << chip);
+         }
+         // receive buffer overflows are counted via the error interrupt
+         if((0 != pending[chip]) || mcp2515_rx_check_overflow((eChipSelect)chip))
+         {
+            busy = true;
+         }
+         else
+         {
+            // e.g. wake up interrupt, nothing to read
+            idle |= (uint8_t)(1 << chip);
+         }
+      }
+
+      // both buffers full first, then the others, each round robin
+      chip = first;
+      for(i = 0; i < 2 * NUM_OF_MCP2515; ++i)
+      {
+         if((0 != pending[chip]) &&
+            ((i < NUM_OF_MCP2515) == (0 != (full & (1 << chip)))))
+         {
+            queued |= can_rx_read((eChipSelect)chip, pending[chip]);
+         }
+         if(++chip >= NUM_OF_MCP2515)
+         {
+            chip = 0;
+         }
+      }
+      if(++first >= NUM_OF_MCP2515)
+      {
+         first = 0;
+      }
+   }
+
+   return queued;
+}
+
+uint16_t can_rx_frames(eChipSelect chip)
+{
+   return can_rx_count(&frames[chip]);
+}
+
+uint16_t can_rx_dropped(eChipSelect chip)
+{
+   return can_rx_count(&dropped[chip]);
+}
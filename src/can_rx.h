@@ -0,0 +1,80 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file can_rx.h
+ *
+ * Receive scheduler of all MCP2515 sharing the SPI bus. It is run by the
+ * INT0 interrupt service routine and drains the receive buffers of the
+ * controllers into the FIFO (see can_fifo.h) in passes:
+ *
+ * * the INT pins are checked (no SPI access), each controller pending is
+ *   asked for its receive buffers by a single RX STATUS
+ * * controllers with both receive buffers full are served first, since
+ *   the next frame on their bus is lost otherwise
+ * * controllers with the same priority are served round robin, starting
+ *   with the next one each pass
+ * * at most both receive buffers (CAN_RX_BURST frames) are read from a
+ *   controller per pass, so a busy bus can't starve the others
+ *
+ * Passes are repeated until no controller is pending. A controller pending
+ * without anything to read (e.g. wake up interrupt) is not asked again
+ * within the same call.
+ *
+ * \date Created: 16.10.2026 23:39:44
+ * \author agent
+ **/
+
+
+#ifndef CAN_RX_H_
+#define CAN_RX_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "can/can_mcp2515.h"
+#include "mcp2515_burst.h"
+
+// === DEFINITIONS ===========================================================
+
+//! frames read from a controller per pass at most
+#define CAN_RX_BURST             MCP2515_NUM_OF_RXB
+
+// === FUNCTIONS =============================================================
+
+/**
+ * \brief drain the receive buffers of all controllers (ISR only)
+ *
+ * Frames not fitting into the FIFO are read anyway to release the receive
+ * buffer, but counted as dropped.
+ *
+ * \return true, if frames were put into the FIFO
+ */
+bool can_rx_service(void);
+
+// === STATISTICS ============================================================
+
+/**
+ * \brief get number of frames read from a controller
+ * \param chip controller
+ * \return frames since start (wraps around)
+ */
+uint16_t can_rx_frames(eChipSelect chip);
+
+/**
+ * \brief get number of frames of a controller dropped by a full FIFO
+ * \param chip controller
+ * \return frames since start (wraps around)
+ */
+uint16_t can_rx_dropped(eChipSelect chip);
+
+#endif /* CAN_RX_H_ */
@@ -0,0 +1,231 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file config_store.c
+ *
+ * \date Created: 16.10.2026 23:27:30
+ * \author agent
+ **/
+
+
+#include <stddef.h>
+#include <string.h>
+
+#include "hal.h"
+#include "config/matrixbar_config.h"
+#include "config/timer_config.h"
+#include "display.h"
+#include "pdc_filter.h"
+#include "sleep_policy.h"
+#include "systick.h"
+#include "PDCViewer.h"
+#include "config_store.h"
+
+// === DEFINITIONS ===========================================================
+
+//! start value of the CRC
+#define CONFIG_CRC_INIT          0xFFFF
+
+//! bargraph options of the lookup table
+#if defined(MATRIXBAR_REVERSE) && defined(MATRIXBAR_INVERTED)
+   #define CONFIG_BARGRAPH_DEFAULT  (CONFIG_BARGRAPH_REVERSE | CONFIG_BARGRAPH_INVERTED)
+#elif defined(MATRIXBAR_REVERSE)
+   #define CONFIG_BARGRAPH_DEFAULT  CONFIG_BARGRAPH_REVERSE
+#elif defined(MATRIXBAR_INVERTED)
+   #define CONFIG_BARGRAPH_DEFAULT  CONFIG_BARGRAPH_INVERTED
+#else
+   #define CONFIG_BARGRAPH_DEFAULT  0
+#endif
+
+//! records are read and written byte by byte, so there must be no padding
+typedef char config_record_size_check[(sizeof(config_record_t) == CONFIG_RECORD_SIZE) ? 1 : -1];
+
+//! the CRC follows the settings directly, at the same offset on any build
+typedef char config_crc_offset_check[(offsetof(config_record_t, crc) == CONFIG_RECORD_SIZE - 2) ? 1 : -1];
+
+// === GLOBALS ===============================================================
+
+//! default settings
+static const config_t configDefaults PROGMEM =
+{
+   PDC_CAN_ID,
+   SLEEP_POLICY_PDC_MIN,
+   SLEEP_POLICY_PDC_MAX,
+   SLEEP_POLICY_BUS_MIN,
+   SLEEP_POLICY_BUS_MAX,
+   PDC_STALE_AGE,
+   SLEEP_POLICY_PDC_SHIFT,
+   SLEEP_POLICY_BUS_SHIFT,
+   { CONFIG_BITRATE_UNKNOWN, CONFIG_BITRATE_UNKNOWN },
+   TIMER2_COMPARE_VALUE,
+   DISPLAY_BRIGHTNESS_MAX,
+   CONFIG_BARGRAPH_DEFAULT,
+   PDC_FILTER_DEFAULT
+};
+
+//! settings loaded
+static config_t config;
+
+//! slot loaded
+static uint8_t slot = CONFIG_NO_SLOT;
+
+//! sequence number of the slot loaded
+static uint8_t sequence = 0;
+
+//! settings differ from the slot loaded
+static bool changed = false;
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief get EEPROM address of a slot
+ * \param index of slot
+ * \return address of version
+ */
+static uint16_t config_addr(uint8_t index)
+{
+   return (uint16_t)(CONFIG_STORE_ADDR + index * CONFIG_RECORD_SIZE);
+}
+
+/**
+ * \brief get CRC of a record
+ * \param record with all bytes but the CRC set
+ * \return CRC-CCITT
+ */
+static uint16_t config_crc(const config_record_t* record)
+{
+   const uint8_t* data = (const uint8_t*)record;
+   uint16_t       crc  = CONFIG_CRC_INIT;
+   uint8_t        i;
+
+   for(i = 0; i < CONFIG_RECORD_SIZE - sizeof(record->crc); ++i)
+   {
+      crc = hal_crc_ccitt_update(crc, data[i]);
+   }
+   return crc;
+}
+
+// === FUNCTIONS =============================================================
+
+void config_load(void)
+{
+   config_record_t record;
+   uint8_t         rejected = 0;
+   uint8_t         newest;
+   uint8_t         seq;
+   uint8_t         i;
+
+   config_defaults(&config);
+   slot    = CONFIG_NO_SLOT;
+   changed = false;
+
+   do
+   {
+      // newest header of the current version not rejected yet
+      newest = CONFIG_NO_SLOT;
+      for(i = 0; i < CONFIG_STORE_SLOTS; ++i)
+      {
+         if((0 == (rejected & (1 << i))) &&
+            (CONFIG_VERSION == hal_eeprom_read(config_addr(i))))
+         {
+            seq = hal_eeprom_read(config_addr(i) + 1);
+            // sequence numbers of the slots are close, even if wrapped
+            if((CONFIG_NO_SLOT == newest) || ((int8_t)(seq - sequence) > 0))
+            {
+               newest   = i;
+               sequence = seq;
+            }
+         }
+      }
+
+      if((CONFIG_NO_SLOT != newest) && config_read_slot(newest, &record))
+      {
+         config = record.config;
+         slot   = newest;
+      }
+      else if(CONFIG_NO_SLOT != newest)
+      {
+         rejected |= (uint8_t)(1 << newest);
+      }
+   } while((CONFIG_NO_SLOT != newest) && (CONFIG_NO_SLOT == slot));
+}
+
+const config_t* config_get(void)
+{
+   return &config;
+}
+
+void config_defaults(config_t* defaults)
+{
+   memcpy_P(defaults, &configDefaults, sizeof(*defaults));
+}
+
+void config_set(const config_t* settings)
+{
+   if(0 != memcmp(settings, &config, sizeof(config)))
+   {
+      config  = *settings;
+      changed = true;
+   }
+}
+
+bool config_save(void)
+{
+   config_record_t record;
+   const uint8_t*  data = (const uint8_t*)&record;
+   uint16_t        addr;
+   uint8_t         i;
+
+   if(!changed)
+   {
+      return false;
+   }
+
+   slot = (CONFIG_NO_SLOT == slot) ? 0 : (uint8_t)((slot + 1) % CONFIG_STORE_SLOTS);
+   ++sequence;
+
+   record.version  = CONFIG_VERSION;
+   record.sequence = sequence;
+   record.config   = config;
+   record.crc      = config_crc(&record);
+
+   // header last: a record torn by losing power is older or fails the CRC
+   addr = config_addr(slot);
+   for(i = 2; i < CONFIG_RECORD_SIZE; ++i)
+   {
+      hal_eeprom_write(addr + i, data[i]);
+   }
+   hal_eeprom_write(addr + 1, record.sequence);
+   hal_eeprom_write(addr, record.version);
+
+   changed = false;
+   return true;
+}
+
+uint8_t config_slot(void)
+{
+   return slot;
+}
+
+bool config_read_slot(uint8_t index, config_record_t* record)
+{
+   uint8_t* data = (uint8_t*)record;
+   uint16_t addr = config_addr(index);
+   uint8_t  i;
+
+   for(i = 0; i < CONFIG_RECORD_SIZE; ++i)
+   {
+      data[i] = hal_eeprom_read(addr + i);
+   }
+   return (CONFIG_VERSION == record->version) && (config_crc(record) == record->crc);
+}
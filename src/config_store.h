@@ -0,0 +1,186 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file config_store.h
+ *
+ * Settings kept in the EEPROM, so they can be changed without flashing the
+ * firmware. The defaults are the ones of modules/config and the sources.
+ *
+ * The EEPROM holds CONFIG_STORE_SLOTS records of version, sequence number,
+ * settings and a CRC. Each save writes the next slot with the sequence
+ * number incremented, so the writes are spread over all slots. On boot
+ * only the headers are read to find the newest record of the current
+ * version. Just this record is read completely and checked. If its CRC
+ * doesn't match (e.g. power lost while writing), the next older one is
+ * taken. Without any, the defaults are used.
+ *
+ * Settings changed at runtime (e.g. the bitrate detected) are written when
+ * going to sleep, so writing (~8.5ms per byte) doesn't delay the start.
+ *
+ * The record has the byte order of the AVR, so images written by the host
+ * tool (see host/config_tool.c) can be programmed directly.
+ *
+ * \date Created: 16.10.2026 23:27:30
+ * \author agent
+ **/
+
+
+#ifndef CONFIG_STORE_H_
+#define CONFIG_STORE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// === DEFINITIONS ===========================================================
+
+//! version of the record, increment on any change of config_t
+#define CONFIG_VERSION           5
+
+//! EEPROM address of the first slot
+#define CONFIG_STORE_ADDR        0x000
+
+//! number of slots written in turn (up to 8)
+#define CONFIG_STORE_SLOTS       8
+
+/**
+ * \brief bytes of a record (version, sequence, settings, CRC)
+ *
+ * Fixed, so the AVR (-fpack-struct) and the host (natural alignment) must
+ * both lay out config_record_t with exactly this size, see config_store.c.
+ */
+#define CONFIG_RECORD_SIZE       24
+
+//! EEPROM bytes used by all slots
+#define CONFIG_STORE_SIZE        (CONFIG_STORE_SLOTS * CONFIG_RECORD_SIZE)
+
+//! no slot loaded, defaults are used
+#define CONFIG_NO_SLOT           0xFF
+
+//! bitrate not detected yet
+#define CONFIG_BITRATE_UNKNOWN   0xFF
+
+//! buses with a bitrate kept, independent of NUM_OF_MCP2515 built
+#define CONFIG_NUM_OF_BUSES      2
+
+//! bargraph: all pins set for the nearest distance
+#define CONFIG_BARGRAPH_REVERSE  0x01
+//! bargraph: pins inverted
+#define CONFIG_BARGRAPH_INVERTED 0x02
+
+// === TYPE DEFINITIONS ======================================================
+
+/**
+ * \brief settings
+ *
+ * Words first and an even number of bytes, so there is no padding on the
+ * host either (see CONFIG_RECORD_SIZE). Timeouts are given in ticks of
+ * Timer1, see sleep_policy.h.
+ */
+typedef struct
+{
+   //! CAN id of the PDC message (PDC_CAN_ID)
+   uint16_t pdcCanId;
+   //! PDC inactive: minimum timeout
+   uint16_t pdcMin;
+   //! PDC inactive: maximum timeout
+   uint16_t pdcMax;
+   //! bus silent: minimum timeout
+   uint16_t busMin;
+   //! bus silent: maximum timeout (TIMER1_COMPARE_VALUE)
+   uint16_t busMax;
+   //! age of a sensor value blanked (PDC_STALE_AGE), see systick.h
+   uint16_t staleAge;
+   //! PDC inactive: mean interval multiplied by 2^n
+   uint8_t  pdcShift;
+   //! bus silent: mean interval multiplied by 2^n
+   uint8_t  busShift;
+   //! bitrate of each bus (eCanBitRate) or CONFIG_BITRATE_UNKNOWN
+   uint8_t  bitrate[CONFIG_NUM_OF_BUSES];
+   //! compare value of Timer2, multiplex period of a column
+   uint8_t  timer2Compare;
+   //! brightness of the display 0..DISPLAY_BRIGHTNESS_MAX
+   uint8_t  brightness;
+   //! CONFIG_BARGRAPH_REVERSE and/or CONFIG_BARGRAPH_INVERTED
+   uint8_t  bargraph;
+   //! stages of the filter, see pdc_filter.h
+   uint8_t  filter;
+} config_t;
+
+/**
+ * \brief record of a slot
+ */
+typedef struct
+{
+   //! CONFIG_VERSION (0xFF: erased)
+   uint8_t  version;
+   //! incremented by each save, wraps around
+   uint8_t  sequence;
+   //! settings
+   config_t config;
+   //! CRC-CCITT of all bytes above
+   uint16_t crc;
+} config_record_t;
+
+// === FUNCTIONS =============================================================
+
+/**
+ * \brief load the newest valid record or the defaults
+ */
+void config_load(void);
+
+/**
+ * \brief get settings loaded
+ * \return settings
+ */
+const config_t* config_get(void);
+
+/**
+ * \brief get default settings
+ * \param config to fill
+ */
+void config_defaults(config_t* config);
+
+/**
+ * \brief change settings
+ *
+ * Takes effect in RAM at once, see config_save() for the EEPROM.
+ *
+ * \param config settings
+ */
+void config_set(const config_t* config);
+
+/**
+ * \brief save settings changed to the next slot
+ *
+ * Nothing is written, if the settings didn't change since loaded. Only
+ * bytes differing from the old record in the slot are written.
+ *
+ * \return true, if written
+ */
+bool config_save(void);
+
+/**
+ * \brief get slot loaded
+ * \return slot or CONFIG_NO_SLOT
+ */
+uint8_t config_slot(void);
+
+/**
+ * \brief read a slot
+ * \param slot 0..CONFIG_STORE_SLOTS-1
+ * \param record to fill
+ * \return true, if version and CRC are valid
+ */
+bool config_read_slot(uint8_t slot, config_record_t* record);
+
+#endif /* CONFIG_STORE_H_ */
@@ -0,0 +1,288 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file debug.c
+ *
+ * \date Created: 16.10.2026 22:53:03
+ * \author agent
+ **/
+
+
+#include "hal.h"
+#include "debug.h"
+#include "bus_stats.h"
+#include "profiler.h"
+#include "telemetry.h"
+
+// === DEFINITIONS ===========================================================
+
+//! maximum number of digits of a 32bit value
+#define DEBUG_MAX_DIGITS   10
+
+#if defined(DEBUG_CHANNEL) && !defined(TELEMETRY)
+//! the text is sent from the ring by ISR(USART_UDRE_vect)
+#define DEBUG_RING
+#endif
+
+#ifdef DEBUG_RING
+
+//! mask of the ring indices
+#define DEBUG_MASK         (DEBUG_BUFFER_SIZE - 1)
+
+//! a line fits into the ring, the free running indices tell full from empty
+typedef char debug_size_check[(DEBUG_LINE_MAX <= DEBUG_BUFFER_SIZE) &&
+                              (DEBUG_BUFFER_SIZE <= 128) ? 1 : -1];
+
+#endif
+
+#if defined(PROFILING) || defined(BUS_STATS)
+
+/**
+ * \brief dumps sent on request, in this order
+ */
+typedef enum
+{
+   //! profiler_dump_line()
+   DEBUG_DUMP_PROFILER  = 0,
+   //! bus_stats_dump_line()
+   DEBUG_DUMP_BUS_STATS = 1,
+   //! always the last one
+   NUM_OF_DUMPS         = 2
+} eDebugDump;
+
+#endif
+
+// === GLOBALS ===============================================================
+
+#ifdef DEBUG_RING
+
+//! ring buffer of the characters
+static char ring[DEBUG_BUFFER_SIZE];
+
+//! next character to write, only changed by the main loop
+static volatile uint8_t ringHead = 0;
+
+//! next character to send, only changed by ISR(USART_UDRE_vect)
+static volatile uint8_t ringTail = 0;
+
+//! a character was sent since power on, so TXC tells the end
+static volatile bool sending = false;
+
+#endif
+
+#if defined(PROFILING) || defined(BUS_STATS)
+
+//! last state of the dump request
+static bool dumpRequested = false;
+
+//! dump sent (NUM_OF_DUMPS, if none)
+static uint8_t dumpNext = NUM_OF_DUMPS;
+
+//! line of the dump sent next
+static uint8_t dumpLine = 0;
+
+#endif
+
+// === HELPERS ===============================================================
+
+#ifdef TELEMETRY
+
+//! the UART is shared with the records of the telemetry
+#define debug_putc(c)      telemetry_putc(c)
+
+#elif defined(DEBUG_RING)
+
+/**
+ * \brief get free space of the ring
+ * \return characters
+ */
+static uint8_t debug_free(void)
+{
+   return (uint8_t)(DEBUG_BUFFER_SIZE - (uint8_t)(ringHead - ringTail));
+}
+
+/**
+ * \brief put a character into the ring
+ *
+ * Waits in idle mode, if the ring is full. Only dumps sent at once do,
+ * debug_poll() checks debug_ready() before each line.
+ *
+ * \param c character
+ */
+static void debug_putc(char c)
+{
+   hal_irq_disable();
+   while(0 == debug_free())
+   {
+      hal_sleep(SLEEP_MODE_IDLE);
+      hal_irq_disable();
+   }
+   hal_irq_enable();
+
+   ring[ringHead & DEBUG_MASK] = c;
+   ++ringHead;
+   hal_uart_irq_enable();
+}
+
+#else
+
+#define debug_putc(c)      hal_debug_putc(c)
+
+#endif
+
+#if defined(PROFILING) || defined(BUS_STATS)
+
+/**
+ * \brief send a line of a dump
+ * \param dump to send
+ * \param line of the dump, 0 for the first one
+ * \return true, if more lines follow
+ */
+static bool debug_dump_line(uint8_t dump, uint8_t line)
+{
+   if(DEBUG_DUMP_PROFILER == dump)
+   {
+      return profiler_dump_line(line);
+   }
+   return bus_stats_dump_line(line);
+}
+
+#endif
+
+// === INTERRUPTS ============================================================
+
+#ifdef DEBUG_RING
+
+/**
+ * \brief send the next character of the ring
+ *
+ * The data register is empty, so hal_debug_putc() doesn't wait.
+ */
+ISR(USART_UDRE_vect)
+{
+   PROFILE_BEGIN(PROF_ISR_UART);
+   uint8_t tail = ringTail;
+
+   if(tail != ringHead)
+   {
+      hal_debug_putc(ring[tail & DEBUG_MASK]);
+      ringTail = tail + 1;
+      sending  = true;
+   }
+   else
+   {
+      hal_uart_irq_disable();
+   }
+   PROFILE_END(PROF_ISR_UART);
+}
+
+#endif
+
+// === FUNCTIONS =============================================================
+
+void debug_init(void)
+{
+   hal_debug_init();
+}
+
+bool debug_ready(void)
+{
+#ifdef DEBUG_RING
+   return (debug_free() >= DEBUG_LINE_MAX);
+#else
+   // the telemetry sends a line within a few ms
+   return true;
+#endif
+}
+
+void debug_flush(void)
+{
+#ifdef DEBUG_RING
+   hal_irq_disable();
+   while(ringHead != ringTail)
+   {
+      hal_sleep(SLEEP_MODE_IDLE);
+      hal_irq_disable();
+   }
+   hal_irq_enable();
+   // the ring is empty, the interrupt would wake up right away otherwise
+   hal_uart_irq_disable();
+   // the last character is still shifted out
+   while(sending && !hal_uart_sent())
+   {
+   }
+#endif
+}
+
+void debug_puts_P(const char* str)
+{
+   char c;
+
+   while('\0' != (c = (char)pgm_read_byte(str++)))
+   {
+      debug_putc(c);
+   }
+}
+
+void debug_put_dec(uint32_t value, uint8_t width)
+{
+   char    digits[DEBUG_MAX_DIGITS];
+   uint8_t count = 0;
+
+   do
+   {
+      digits[count++] = (char)('0' + (value % 10));
+      value /= 10;
+   } while(0 != value);
+
+   while(width-- > count)
+   {
+      debug_putc(' ');
+   }
+   while(count > 0)
+   {
+      debug_putc(digits[--count]);
+   }
+}
+
+void debug_newline(void)
+{
+   debug_putc('\r');
+   debug_putc('\n');
+}
+
+#if defined(PROFILING) || defined(BUS_STATS)
+
+void debug_poll(void)
+{
+   bool requested = hal_debug_requested();
+
+   // dump once per request
+   if(requested && !dumpRequested)
+   {
+      dumpNext = 0;
+      dumpLine = 0;
+   }
+   dumpRequested = requested;
+
+   if((dumpNext < NUM_OF_DUMPS) && debug_ready())
+   {
+      if(!debug_dump_line(dumpNext, dumpLine++))
+      {
+         ++dumpNext;
+         dumpLine = 0;
+      }
+   }
+}
+
+#endif
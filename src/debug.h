@@ -0,0 +1,98 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file debug.h
+ *
+ * Text output via the debug channel of the HAL. The characters are put into
+ * a ring buffer sent by ISR(USART_UDRE_vect), waiting only if it is full.
+ * At 9600 baud a dump takes more than a second, so debug_poll() sends the
+ * dumps requested one line per tick, as long as the line fits into the
+ * ring. The main loop never waits for the UART then.
+ *
+ * With TELEMETRY the text is sent as records of the telemetry, waiting for
+ * space in its ring buffer (see telemetry.h). At 250000 baud a line takes
+ * less than 5ms, so debug_ready() is always true then.
+ *
+ * \date Created: 16.10.2026 22:53:03
+ * \author agent
+ **/
+
+
+#ifndef DEBUG_H_
+#define DEBUG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// === DEFINITIONS ===========================================================
+
+//! size of the ring buffer (2^n, the indices are 8bit)
+#define DEBUG_BUFFER_SIZE        128
+
+//! longest line of a dump including CR LF
+#define DEBUG_LINE_MAX           100
+
+// === FUNCTIONS =============================================================
+
+/**
+ * \brief initialize debug channel
+ */
+void debug_init(void);
+
+/**
+ * \brief check if the ring buffer takes a line without waiting
+ * \return true, if DEBUG_LINE_MAX characters fit
+ */
+bool debug_ready(void);
+
+/**
+ * \brief wait until the ring buffer is sent (e.g. before powering down)
+ */
+void debug_flush(void);
+
+/**
+ * \brief send string from flash
+ * \param str string in flash (PSTR)
+ */
+void debug_puts_P(const char* str);
+
+/**
+ * \brief send decimal number right aligned
+ * \param value to send
+ * \param width minimum number of characters
+ */
+void debug_put_dec(uint32_t value, uint8_t width);
+
+/**
+ * \brief send end of line
+ */
+void debug_newline(void);
+
+#if defined(PROFILING) || defined(BUS_STATS)
+
+/**
+ * \brief send the next line of the dumps requested (main loop, each tick)
+ *
+ * Pulling the request pin low starts the dumps of the profiler and the bus
+ * statistics, one after the other (see profiler_dump_line() and
+ * bus_stats_dump_line()). A line is only sent, if debug_ready().
+ */
+void debug_poll(void);
+
+#else
+
+#define debug_poll()
+
+#endif
+
+#endif /* DEBUG_H_ */
@@ -0,0 +1,183 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file display.c
+ *
+ * \date Created: 16.10.2026 23:03:26
+ * \author agent
+ **/
+
+
+#include "hal.h"
+#include "matrixbar/matrixbar.h"
+#include "display.h"
+#include "PDCViewer.h"
+
+// === TABLES ================================================================
+
+/**
+ * \brief distance bands blinking
+ *
+ * Sorted by distance, the first band matching is used. With refreshes of
+ * all columns at ~93Hz, bit 4 blinks at ~2.9Hz and bit 5 at ~1.5Hz.
+ */
+static const display_band_t bands[] PROGMEM =
+{
+   //below blink
+   { 30,   (1 << 4) },  // fast
+   { 60,   (1 << 5) }   // slow
+};
+
+//! number of bands
+#define DISPLAY_NUM_OF_BANDS     (sizeof(bands) / sizeof(bands[0]))
+
+// === GLOBALS ===============================================================
+
+//! front and back buffer
+static display_frame_t frames[2];
+
+//! index of the front buffer, the other one is the back buffer
+static volatile uint8_t frontFrame = 0;
+
+//! brightness level
+static volatile uint8_t brightness = DISPLAY_BRIGHTNESS_MAX;
+
+//! length of one unit of the bit angle modulation in ticks of Timer2
+static uint8_t bamUnit = 1;
+
+//! ticks of the time slot left over by the units, added to the last phase
+static uint8_t bamRest = 0;
+
+//! column shown (used by ISR only)
+static uint8_t scanColumn = 0;
+
+//! phase of the bit angle modulation (used by ISR only)
+static uint8_t scanPhase = DISPLAY_BAM_BITS - 1;
+
+//! refreshes of all columns (used by ISR only)
+static uint8_t scanRefresh = 0;
+
+//! column is blinked off in this refresh (used by ISR only)
+static bool scanBlank = false;
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief get blinking of a distance
+ * \param value distance
+ * \return refresh counter bit or 0
+ */
+static uint8_t display_blink(uint8_t value)
+{
+   uint8_t i;
+
+   for(i = 0; i < DISPLAY_NUM_OF_BANDS; ++i)
+   {
+      if(value < pgm_read_byte(&bands[i].below))
+      {
+         return pgm_read_byte(&bands[i].blink);
+      }
+   }
+   return 0;
+}
+
+// === FUNCTIONS =============================================================
+
+void display_init(void)
+{
+   uint8_t col;
+
+   for(col = 0; col < MATRIXBAR_COLUMNS; ++col)
+   {
+      bargraph_pattern(PDC_OUT_OF_RANGE, frames[0].pins[col]);
+      bargraph_pattern(PDC_OUT_OF_RANGE, frames[1].pins[col]);
+      frames[0].blink[col] = 0;
+      frames[1].blink[col] = 0;
+   }
+   frontFrame = 0;
+   scanColumn = 0;
+   scanPhase  = DISPLAY_BAM_BITS - 1;
+
+   // time slot of a column split into units (only once, no division in ISR),
+   // the remainder keeps the slot as long as set (e.g. 10 ticks: 1, 2, 4+3)
+   bamUnit = (uint8_t)((hal_timer2_compare() + 1) / DISPLAY_BRIGHTNESS_MAX);
+   bamRest = (uint8_t)((hal_timer2_compare() + 1) % DISPLAY_BRIGHTNESS_MAX);
+   if(0 == bamUnit)
+   {
+      // too short, stretched to one tick per unit
+      bamUnit = 1;
+      bamRest = 0;
+   }
+}
+
+void display_set_brightness(uint8_t level)
+{
+   brightness = (level < DISPLAY_BRIGHTNESS_MAX) ? level : DISPLAY_BRIGHTNESS_MAX;
+}
+
+void display_update(const uint8_t* values)
+{
+   uint8_t back = frontFrame ^ 1;
+   uint8_t col;
+
+   for(col = 0; col < MATRIXBAR_COLUMNS; ++col)
+   {
+      bargraph_pattern(values[col], frames[back].pins[col]);
+      frames[back].blink[col] = display_blink(values[col]);
+   }
+   frontFrame = back;
+}
+
+bool display_scan(void)
+{
+   const display_frame_t* frame;
+   bool                   refresh = false;
+
+   if(++scanPhase >= DISPLAY_BAM_BITS)
+   {
+      // next column, the frame is read once per column
+      scanPhase = 0;
+      matrixbar_reset_col(scanColumn);
+      if(++scanColumn >= MATRIXBAR_COLUMNS)
+      {
+         scanColumn = 0;
+         ++scanRefresh;
+         refresh = true;
+      }
+      frame     = &frames[frontFrame];
+      scanBlank = (0 != (scanRefresh & frame->blink[scanColumn]));
+      bargraph_write(frame->pins[scanColumn]);
+      hal_trace_shown(scanColumn);
+   }
+
+   if(!scanBlank && (brightness & (1 << scanPhase)))
+   {
+      matrixbar_set_col(scanColumn);
+   }
+   else
+   {
+      matrixbar_reset_col(scanColumn);
+   }
+
+   // phase n lasts 2^n units, the last one the remainder of the slot, too
+   if(scanPhase < (DISPLAY_BAM_BITS - 1))
+   {
+      hal_timer2_set_compare((uint8_t)((bamUnit << scanPhase) - 1));
+   }
+   else
+   {
+      hal_timer2_set_compare((uint8_t)((bamUnit << scanPhase) + bamRest - 1));
+   }
+
+   return refresh;
+}
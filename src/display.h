@@ -0,0 +1,119 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file display.h
+ *
+ * Double buffered framebuffer of the matrixbar. The main loop writes the
+ * row pins of all columns into the back buffer and swaps it with the front
+ * buffer. ISR(TIMER2_COMP_vect) scans out the front buffer one column after
+ * the other, so the timing of the display does not depend on CAN reception
+ * and decoding.
+ *
+ * Brightness is set by bit angle modulation: the time slot of a column is
+ * split into DISPLAY_BAM_BITS phases of 1, 2, 4, ... units. The column is
+ * switched on in the phases whose bit is set in the brightness level.
+ * Timer2 is set to the length of each phase, so there are DISPLAY_BAM_BITS
+ * interrupts per column instead of one.
+ *
+ * Columns showing a distance below a configured band blink. Blinking
+ * switches the column off every other 2^n refreshes of all columns, so
+ * the rate does not depend on the number of columns (see
+ * MATRIXBAR_FRAME_TICKS).
+ *
+ * \date Created: 16.10.2026 23:03:26
+ * \author agent
+ **/
+
+
+#ifndef DISPLAY_H_
+#define DISPLAY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "config/matrixbar_config.h"
+#include "bargraph.h"
+
+// === DEFINITIONS ===========================================================
+
+/**
+ * \brief number of bits of the bit angle modulation
+ *
+ * Gives 2^n brightness levels. The time slot of a column (in ticks of
+ * Timer2) is divided into 2^n - 1 units, so it should be at least that
+ * long. Ticks left over are added to the last (longest) phase.
+ */
+#define DISPLAY_BAM_BITS         3
+
+//! maximum brightness (always on)
+#define DISPLAY_BRIGHTNESS_MAX   ((1 << DISPLAY_BAM_BITS) - 1)
+
+// === TYPE DEFINITIONS ======================================================
+
+/**
+ * \brief row pins of all columns
+ */
+typedef struct
+{
+   //! pins per column and port of P_MATRIXBAR_ROW
+   uint8_t pins[MATRIXBAR_COLUMNS][BARGRAPH_NUM_OF_PORTS];
+   //! refresh counter bit switching the column off (0: no blinking)
+   uint8_t blink[MATRIXBAR_COLUMNS];
+} display_frame_t;
+
+/**
+ * \brief distance band blinking
+ */
+typedef struct
+{
+   //! distances below blink
+   uint8_t below;
+   //! refresh counter bit switching the column off
+   uint8_t blink;
+} display_band_t;
+
+// === FUNCTIONS =============================================================
+
+/**
+ * \brief init both buffers with nothing in range and start at column 0
+ *
+ * Takes the current compare value of Timer2 as the time slot of a column.
+ */
+void display_init(void);
+
+/**
+ * \brief set brightness of all columns
+ * \param level 0 (off) .. DISPLAY_BRIGHTNESS_MAX
+ */
+void display_set_brightness(uint8_t level);
+
+/**
+ * \brief write values into the back buffer and show it
+ *
+ * The buffers are swapped by writing a single byte, so the ISR sees either
+ * the old or the new frame, but never parts of both.
+ *
+ * \param values one per column
+ */
+void display_update(const uint8_t* values);
+
+/**
+ * \brief show next phase or column of the front buffer
+ *
+ * Called by ISR(TIMER2_COMP_vect).
+ *
+ * \return true, if a refresh of all columns starts
+ */
+bool display_scan(void);
+
+#endif /* DISPLAY_H_ */
@@ -0,0 +1,61 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file events.c
+ *
+ * \date Created: 16.10.2026 23:08:09
+ * \author agent
+ **/
+
+
+#include "hal.h"
+#include "events.h"
+
+// === GLOBALS ===============================================================
+
+//! pending events, set by the ISRs and cleared by the main loop
+static volatile uint8_t pendingEvents = 0;
+
+// === FUNCTIONS =============================================================
+
+void events_post(uint8_t events)
+{
+   pendingEvents |= events;
+}
+
+uint8_t events_take(void)
+{
+   uint8_t state = hal_irq_save();
+   uint8_t events = pendingEvents;
+
+   pendingEvents = 0;
+   hal_irq_restore(state);
+
+   return events;
+}
+
+uint8_t events_wait(void)
+{
+   hal_irq_disable();
+   if(0 == pendingEvents)
+   {
+      // sei and sleep are executed atomically, so an event posted after
+      // checking still wakes up
+      hal_sleep(SLEEP_MODE_IDLE);
+   }
+   else
+   {
+      hal_irq_enable();
+   }
+   return events_take();
+}
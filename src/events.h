@@ -0,0 +1,68 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file events.h
+ *
+ * Events posted by the interrupt service routines to the main loop. Each
+ * event is a bit of a single byte, so posting the same event twice before
+ * the main loop takes it results in one event only. The main loop sleeps
+ * in idle mode as long as no event is pending.
+ *
+ * \date Created: 16.10.2026 23:08:09
+ * \author agent
+ **/
+
+
+#ifndef EVENTS_H_
+#define EVENTS_H_
+
+#include <stdint.h>
+
+// === DEFINITIONS ===========================================================
+
+//! frames were received into the FIFO (INT0)
+#define EVENT_FRAME              (1 << 0)
+
+//! no activity on the bus for the bus silent timeout (Timer1 capture, see
+//! sleep_policy_bus_timeout())
+#define EVENT_BUS_SILENT         (1 << 1)
+
+//! all columns of the display were refreshed (Timer2 compare, ~93Hz)
+#define EVENT_TICK               (1 << 2)
+
+// === FUNCTIONS =============================================================
+
+/**
+ * \brief post events (ISR only)
+ * \param events to set
+ */
+void events_post(uint8_t events);
+
+/**
+ * \brief get and clear all pending events
+ * \return events pending
+ */
+uint8_t events_take(void);
+
+/**
+ * \brief sleep until an event is pending, then get and clear all events
+ *
+ * The CPU enters idle mode, so timers and SPI keep running and any
+ * interrupt wakes it up. Interrupts not posting an event return 0, so the
+ * caller simply waits again.
+ *
+ * \return events pending or 0
+ */
+uint8_t events_wait(void);
+
+#endif /* EVENTS_H_ */
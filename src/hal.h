@@ -0,0 +1,297 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file hal.h
+ *
+ * Hardware abstraction of everything the FSM touches besides the modules.
+ * On the AVR all functions map directly to avr-libc and the registers, so
+ * no code is added. On the host the stubs found in host/ are used.
+ *
+ * \date Created: 16.10.2026 22:46:35
+ * \author agent
+ **/
+
+
+#ifndef HAL_H_
+#define HAL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//! baud rate of the debug channel (see hal_debug_init())
+#define HAL_DEBUG_BAUD           9600UL
+
+#ifdef __AVR__
+   #include "hal_avr.h"
+#else
+   #include "host/hal_host.h"
+#endif
+
+/**
+ * \fn hal_running()
+ * \brief condition of the main loop
+ *
+ * Always true on the AVR. The host returns false, if the simulation ends.
+ */
+
+/**
+ * \fn hal_irq_disable()
+ * \brief disable all interrupts globally (cli)
+ */
+
+/**
+ * \fn hal_irq_enable()
+ * \brief enable all interrupts globally (sei)
+ */
+
+/**
+ * \fn hal_irq_save()
+ * \brief disable all interrupts and save the previous state
+ * \return state to be given to hal_irq_restore()
+ */
+
+/**
+ * \fn hal_irq_restore(state)
+ * \brief restore interrupt state
+ * \param state saved by hal_irq_save()
+ */
+
+/**
+ * \fn hal_can_irq_init()
+ * \brief set trigger of the CAN interrupt INT0 (MCP2515 INT)
+ * \sa EXTERNAL_INT0_TRIGGER
+ */
+
+/**
+ * \fn hal_can_irq_enable()
+ * \brief enable the CAN interrupt INT0 (receive and wake up)
+ */
+
+/**
+ * \fn hal_can_irq_disable()
+ * \brief disable the CAN interrupt INT0
+ */
+
+/**
+ * \fn hal_sleep(mode)
+ * \brief enter sleep mode with interrupts enabled and return after wake up
+ * \param mode to be used, e.g. SLEEP_MODE_PWR_DOWN
+ */
+
+/**
+ * \fn hal_can_select(chip)
+ * \brief select MCP2515 for SPI transfer (CS low)
+ * \param chip to select
+ */
+
+/**
+ * \fn hal_can_deselect(chip)
+ * \brief release MCP2515 after SPI transfer (CS high)
+ * \param chip to release
+ */
+
+/**
+ * \fn hal_cycles_init()
+ * \brief start free running cycle counter
+ */
+
+/**
+ * \fn hal_cycles()
+ * \brief get free running cycle counter
+ *
+ * CPU cycles on the AVR. Virtual cycles on the host, only SPI, EEPROM and
+ * UART accesses take time there.
+ *
+ * \return counter (wraps around)
+ */
+
+/**
+ * \fn hal_debug_init()
+ * \brief init the debug channel
+ *
+ * Sets up the UART for HAL_DEBUG_BAUD, unless TELEMETRY shares it.
+ */
+
+/**
+ * \fn hal_debug_putc(c)
+ * \brief send character via debug channel (UART on the AVR, stdout on the
+ *        host)
+ *
+ * Waits for the data register to be empty, so it is called by
+ * ISR(USART_UDRE_vect) of debug.c. The host takes the time of the UART.
+ *
+ * \param c character
+ */
+
+/**
+ * \fn hal_debug_requested()
+ * \brief check for a request to dump debug information
+ *
+ * The request pin on the AVR. The host requests at the time given by
+ * host_debug_request(), if any, and dumps at the end of the simulation.
+ *
+ * \return true, as long as requested
+ */
+
+/**
+ * \fn hal_uart_init(baud)
+ * \brief init the UART for sending only (8N1)
+ * \param baud rate
+ */
+
+/**
+ * \fn hal_uart_put(byte)
+ * \brief write the data register of the UART, if it is empty
+ * \param byte to send
+ */
+
+/**
+ * \fn hal_uart_irq_enable()
+ * \brief enable the data register empty interrupt (USART_UDRE_vect)
+ */
+
+/**
+ * \fn hal_uart_irq_disable()
+ * \brief disable the data register empty interrupt
+ */
+
+/**
+ * \fn hal_uart_sent()
+ * \brief check if the UART sent the last byte written completely (by
+ *        hal_uart_put() or hal_debug_putc())
+ * \return true, if nothing is left to shift out
+ */
+
+/**
+ * \fn hal_delay_ms(ms)
+ * \brief busy wait
+ * \param ms time to wait in milliseconds
+ */
+
+/**
+ * \fn hal_eeprom_read(addr)
+ * \brief read a byte of the EEPROM
+ * \param addr 0..E2END
+ * \return value
+ */
+
+/**
+ * \fn hal_eeprom_write(addr, value)
+ * \brief write a byte of the EEPROM, if it differs
+ *
+ * Busy waits for a write still in progress (~8.5ms each).
+ *
+ * \param addr 0..E2END
+ * \param value to write
+ */
+
+/**
+ * \fn hal_crc_ccitt_update(crc, data)
+ * \brief update CRC-CCITT (polynomial 0x1021, LSB first) by a byte
+ *
+ * Same as _crc_ccitt_update() of avr-libc.
+ *
+ * \param crc so far, start with 0xFFFF
+ * \param data byte
+ * \return updated CRC
+ */
+
+/**
+ * \fn hal_timer2_compare()
+ * \brief get compare value of Timer2 (OCR2)
+ * \return compare value
+ */
+
+/**
+ * \fn hal_timer2_set_compare(value)
+ * \brief set compare value of Timer2 (OCR2)
+ *
+ * Timer2 runs in CTC mode, so the value takes effect right after a compare
+ * match, e.g. when set by ISR(TIMER2_COMP_vect).
+ *
+ * \param value compare value
+ */
+
+/**
+ * \fn hal_timer1_count()
+ * \brief get count of Timer1 (TCNT1)
+ *
+ * Timer1 is reset by each frame received, so the count is the time since
+ * the last frame in ticks of 256us.
+ *
+ * \return count
+ */
+
+/**
+ * \fn hal_timer1_set_compare(value)
+ * \brief set TOP of Timer1 (ICR1), i.e. the bus sleep timeout
+ *
+ * The count needs to be below the new value, otherwise the compare match
+ * is missed until the counter wraps around. So set it right after
+ * resetting the count.
+ *
+ * \param value compare value
+ */
+
+/**
+ * \fn hal_trace_init()
+ * \brief init trace points
+ *
+ * With LATENCY_PIN defined, the AVR drives the test pin PB0 high from
+ * decoding a frame until its values are shown. The end-to-end latency is
+ * measured by a scope from the falling edge of INT (PD2) to the falling
+ * edge of PB0.
+ */
+
+/**
+ * \fn hal_trace_rx(msg)
+ * \brief trace point: frame was read from the CAN controller
+ *
+ * Empty on the AVR. The host measures the latencies of the frames.
+ *
+ * \param msg pointer to the frame read
+ */
+
+/**
+ * \fn hal_trace_decoded(msg)
+ * \brief trace point: frame was decoded and PDC values are updated
+ * \param msg pointer to the frame, same as given to hal_trace_rx()
+ */
+
+/**
+ * \fn hal_trace_filtered(slot, raw, value)
+ * \brief trace point: value of a sensor was filtered
+ *
+ * Empty on the AVR. The host compares the changes from frame to frame.
+ *
+ * \param slot of the sensor
+ * \param raw value decoded
+ * \param value value filtered
+ */
+
+/**
+ * \fn hal_trace_shown(col)
+ * \brief trace point: value of a column is set in the matrixbar
+ * \param col column shown
+ */
+
+/**
+ * \fn hal_trace_state(state)
+ * \brief trace point: FSM entered a state
+ *
+ * Empty on the AVR. The host measures the residency of the states.
+ *
+ * \param state entered
+ */
+
+#endif /* HAL_H_ */
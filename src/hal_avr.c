@@ -0,0 +1,42 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file hal_avr.c
+ *
+ * Parts of the AVR hardware abstraction which need to be compiled once.
+ *
+ * \date Created: 16.10.2026 22:53:03
+ * \author agent
+ **/
+
+
+#include "hal.h"
+
+#ifdef PROFILING
+
+// === CYCLE COUNTER =========================================================
+
+volatile uint8_t halCyclesHigh = 0;
+
+/**
+ * \brief interrupt service routine for Timer0 overflow
+ *
+ * Extends the cycle counter to 16bit. This costs some cycles every 256
+ * cycles, which are included in all measurements.
+ **/
+ISR(TIMER0_OVF_vect)
+{
+   ++halCyclesHigh;
+}
+
+#endif
@@ -0,0 +1,260 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file hal_avr.h
+ *
+ * AVR implementation of the hardware abstraction. Do not include directly,
+ * use hal.h instead.
+ *
+ * \date Created: 16.10.2026 22:46:35
+ * \author agent
+ **/
+
+
+#ifndef HAL_AVR_H_
+#define HAL_AVR_H_
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <avr/cpufunc.h>
+#include <avr/pgmspace.h>
+#include <avr/eeprom.h>
+#include <util/crc16.h>
+#include <util/delay.h>
+
+#include "config/can_config_mcp2515.h"
+
+#define hal_running()            (true)
+
+#define hal_irq_disable()        cli()
+#define hal_irq_enable()         sei()
+
+/**
+ * \brief disable interrupts and save the previous state
+ * \return status register
+ */
+static inline uint8_t hal_irq_save(void)
+{
+   uint8_t sreg = SREG;
+   cli();
+   return sreg;
+}
+
+/**
+ * \brief restore interrupt state saved by hal_irq_save()
+ * \param sreg status register
+ */
+static inline void hal_irq_restore(uint8_t sreg)
+{
+   SREG = sreg;
+}
+
+#define hal_can_irq_init()       MCUCR |= EXTERNAL_INT0_TRIGGER
+#define hal_can_irq_enable()     GICR  |= EXTERNAL_INT0_ENABLE
+#define hal_can_irq_disable()    GICR  &= ~(EXTERNAL_INT0_ENABLE)
+
+#define hal_delay_ms(ms)         _delay_ms(ms)
+
+#define hal_eeprom_read(addr)           eeprom_read_byte((const uint8_t*)(uint16_t)(addr))
+#define hal_eeprom_write(addr, value)   eeprom_update_byte((uint8_t*)(uint16_t)(addr), (value))
+#define hal_crc_ccitt_update(crc, data) _crc_ccitt_update((crc), (data))
+
+#define hal_timer2_compare()            (OCR2)
+#define hal_timer2_set_compare(value)   OCR2 = (value)
+#define hal_timer1_count()              (TCNT1)
+#define hal_timer1_set_compare(value)   ICR1 = (value)
+
+/**
+ * \brief select MCP2515 for SPI transfer (CS low)
+ * \param chip to select
+ */
+static inline void hal_can_select(eChipSelect chip)
+{
+   portaccess_t* cs = getCSPort(chip);
+   *(cs->port) &= ~(1 << cs->pin);
+}
+
+/**
+ * \brief release MCP2515 after SPI transfer (CS high)
+ * \param chip to release
+ */
+static inline void hal_can_deselect(eChipSelect chip)
+{
+   portaccess_t* cs = getCSPort(chip);
+   *(cs->port) |= (1 << cs->pin);
+}
+
+// === CYCLE COUNTER =========================================================
+
+/**
+ * \brief high byte of the cycle counter, incremented by TIMER0_OVF_vect
+ */
+extern volatile uint8_t halCyclesHigh;
+
+/**
+ * \brief start Timer0 as free running cycle counter (clkI/O, no prescaling)
+ */
+#define hal_cycles_init()        do { TCCR0 = (1 << CS00); TIMSK |= (1 << TOIE0); } while(0)
+
+/**
+ * \brief get cycle counter
+ *
+ * Timer0 is extended by its overflow interrupt to 16bit. A pending
+ * overflow not yet counted by the ISR is taken into account.
+ *
+ * \return CPU cycles (wraps after 65536 cycles)
+ */
+static inline uint16_t hal_cycles(void)
+{
+   uint8_t sreg = SREG;
+   uint8_t low;
+   uint8_t high;
+
+   cli();
+   low  = TCNT0;
+   high = halCyclesHigh;
+   if((TIFR & (1 << TOV0)) && (low < 0x80))
+   {
+      ++high;
+   }
+   SREG = sreg;
+
+   return (uint16_t)((high << 8) | low);
+}
+
+// === DEBUG CHANNEL =========================================================
+
+//! pin requesting a debug dump (low active, internal pull-up)
+#define HAL_DEBUG_REQUEST_PIN    PB1
+
+#ifdef TELEMETRY
+
+/**
+ * \brief init request pin of debug channel, the UART is set up by
+ *        hal_uart_init()
+ */
+#define hal_debug_init()         do { DDRB  &= ~(1 << HAL_DEBUG_REQUEST_PIN);          \
+                                      PORTB |= (1 << HAL_DEBUG_REQUEST_PIN); } while(0)
+
+#else
+
+/**
+ * \brief init UART (TX only, 8N1) and request pin of debug channel
+ */
+#define hal_debug_init()         do { UBRRH = 0;                                         \
+                                      UBRRL = (F_CPU / (16UL * HAL_DEBUG_BAUD)) - 1;   \
+                                      UCSRC = (1 << URSEL) | (1 << UCSZ1) | (1 << UCSZ0); \
+                                      UCSRB = (1 << TXEN);                             \
+                                      DDRB  &= ~(1 << HAL_DEBUG_REQUEST_PIN);          \
+                                      PORTB |= (1 << HAL_DEBUG_REQUEST_PIN); } while(0)
+
+#endif
+
+/**
+ * \brief send character via debug channel, waiting for the data register
+ *        to be empty
+ * \param c character to send
+ */
+static inline void hal_debug_putc(char c)
+{
+   while(0 == (UCSRA & (1 << UDRE)))
+   {
+   }
+   // cleared by writing one, see hal_uart_sent()
+   UCSRA |= (1 << TXC);
+   UDR = (uint8_t)c;
+}
+
+//! check if a debug dump is requested
+#define hal_debug_requested()    (0 == (PINB & (1 << HAL_DEBUG_REQUEST_PIN)))
+
+// === UART ==================================================================
+
+/**
+ * \brief init UART (TX only, 8N1, double speed)
+ * \param baud rate, F_CPU / (8 * baud) needs to be an integer
+ */
+#define hal_uart_init(baud)      do { UBRRH = 0;                                         \
+                                      UBRRL = (F_CPU / (8UL * (baud))) - 1;            \
+                                      UCSRA = (1 << U2X);                              \
+                                      UCSRC = (1 << URSEL) | (1 << UCSZ1) | (1 << UCSZ0); \
+                                      UCSRB = (1 << TXEN); } while(0)
+
+/**
+ * \brief write the data register, TXC is cleared to tell the end of sending
+ * \param byte to send
+ */
+#define hal_uart_put(byte)       do { UCSRA |= (1 << TXC); UDR = (byte); } while(0)
+
+#define hal_uart_irq_enable()    UCSRB |= (1 << UDRIE)
+#define hal_uart_irq_disable()   UCSRB &= ~(1 << UDRIE)
+#define hal_uart_sent()          (0 != (UCSRA & (1 << TXC)))
+
+// === TRACE =================================================================
+
+#if defined(PDC_ALL_SENSORS) && (defined(LATENCY_PIN) || defined(DEBUG_CHANNEL))
+   #error "PB0 and PB1 are columns of the matrixbar, if all sensors are shown"
+#endif
+
+#if defined(CAN_SECOND_CHIP) && \
+    (defined(PDC_ALL_SENSORS) || defined(LATENCY_PIN) || defined(DEBUG_CHANNEL))
+   #error "PB0 and PB1 are INT and CS of the second MCP2515"
+#endif
+
+#define hal_trace_rx(msg)        ((void)(msg))
+#define hal_trace_state(state)   ((void)(state))
+#define hal_trace_filtered(slot, raw, value)
+
+#ifdef LATENCY_PIN
+
+//! test pin, high while decoded values wait for the matrixbar
+#define HAL_LATENCY_PIN          PB0
+
+#define hal_trace_init()         DDRB  |= (1 << HAL_LATENCY_PIN)
+#define hal_trace_decoded(msg)   PORTB |= (1 << HAL_LATENCY_PIN)
+#define hal_trace_shown(col)     PORTB &= ~(1 << HAL_LATENCY_PIN)
+
+#else
+
+#define hal_trace_init()
+#define hal_trace_decoded(msg)   ((void)(msg))
+#define hal_trace_shown(col)     ((void)(col))
+
+#endif
+
+// === SLEEP =================================================================
+
+/**
+ * \brief enter sleep mode
+ * \param mode to be used, e.g. SLEEP_MODE_PWR_DOWN
+ *
+ * sleep_mode() has a possible race condition in it, so it is split here.
+ * The three \c _NOP(); instructions are a safety, since older AVRs may
+ * skip the next couple of instructions after sleep mode.
+ */
+static inline void hal_sleep(uint8_t mode)
+{
+   set_sleep_mode(mode);
+   sleep_enable();
+   sei();
+   sleep_cpu();
+   sleep_disable();
+
+   // just in case...
+   _NOP();
+   _NOP();
+   _NOP();
+}
+
+#endif /* HAL_AVR_H_ */
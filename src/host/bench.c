@@ -0,0 +1,167 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file bench.c
+ *
+ * \date Created: 16.10.2026 22:58:58
+ * \author agent
+ **/
+
+
+#include <string.h>
+
+#include "hal.h"
+#include "bench.h"
+#include "replay.h"
+#include "PDCViewer.h"
+
+// === DEFINITIONS ===========================================================
+
+//! length of PDC frames
+#define BENCH_PDC_LENGTH      8
+
+//! length of other frames
+#define BENCH_LOAD_LENGTH     8
+
+//! highest distance generated (raw value, below out of range)
+#define BENCH_MAX_DISTANCE    200
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief pseudo random numbers (xorshift32)
+ * \param bench generator state
+ * \return next number
+ */
+static uint32_t bench_random(bench_t* bench)
+{
+   uint32_t x = bench->random;
+
+   x ^= x << 13;
+   x ^= x >> 17;
+   x ^= x << 5;
+   bench->random = x;
+   return x;
+}
+
+/**
+ * \brief schedule next frame loading the bus
+ * \param bench generator state
+ */
+static void bench_schedule_load(bench_t* bench)
+{
+   uint64_t mean;
+
+   if(0 == bench->load)
+   {
+      bench->nextLoad = HOST_NO_EVENT;
+      return;
+   }
+   // uniformly distributed gaps around the mean giving the load
+   mean = replay_frame_cycles(bench->bitrate, false, BENCH_LOAD_LENGTH) * 100 / bench->load;
+   bench->nextLoad += bench_random(bench) % (2 * mean + 1);
+}
+
+/**
+ * \brief move a time while parked to the start of the next drive
+ * \param bench generator state
+ * \param at time of a frame, updated
+ */
+static void bench_skip_park(const bench_t* bench, uint64_t* at)
+{
+   uint64_t cycle = bench->drive + bench->park;
+   uint64_t phase;
+
+   if((0 == bench->drive) || (HOST_NO_EVENT == *at) || (*at < bench->start))
+   {
+      return;
+   }
+   phase = (*at - bench->start) % cycle;
+   if(phase >= bench->drive)
+   {
+      *at += cycle - phase;
+   }
+}
+
+// === API ===================================================================
+
+void bench_init(bench_t* bench, uint32_t bitrate, uint16_t periodMs,
+                uint8_t load, uint8_t noise, uint64_t start)
+{
+   memset(bench, 0, sizeof(*bench));
+   bench->bitrate  = bitrate;
+   bench->period   = (uint64_t)periodMs * HOST_CYCLES_PER_MS;
+   bench->load     = load;
+   bench->noise    = noise;
+   bench->start    = start;
+   bench->nextPdc  = start;
+   bench->nextLoad = start;
+   bench->busFree  = start;
+   bench->random   = 0x2545F491;
+   bench_schedule_load(bench);
+}
+
+void bench_set_cycle(bench_t* bench, uint32_t driveMs, uint32_t parkMs)
+{
+   bench->drive = (uint64_t)driveMs * HOST_CYCLES_PER_MS;
+   bench->park  = (uint64_t)parkMs * HOST_CYCLES_PER_MS;
+}
+
+bool bench_next(void* context, uint64_t* at, can_t* msg)
+{
+   bench_t* bench = (bench_t*)context;
+   uint64_t ready;
+   uint8_t  i;
+
+   memset(msg, 0, sizeof(*msg));
+   bench_skip_park(bench, &bench->nextPdc);
+   bench_skip_park(bench, &bench->nextLoad);
+   if(bench->nextPdc <= bench->nextLoad)
+   {
+      ready           = bench->nextPdc;
+      bench->nextPdc += bench->period;
+      msg->msgId      = PDC_CAN_ID;
+      msg->header.len = BENCH_PDC_LENGTH;
+      for(i = 0; i < BENCH_PDC_LENGTH; ++i)
+      {
+         // every sensor changes its distance with every frame
+         msg->data[i] = (uint8_t)((bench->pdcFrames * 7 + i * 23) % BENCH_MAX_DISTANCE);
+         if((0 != bench->noise) && ((bench_random(bench) % 100) < bench->noise))
+         {
+            msg->data[i] = (uint8_t)(bench_random(bench) % BENCH_MAX_DISTANCE);
+         }
+      }
+      ++bench->pdcFrames;
+   }
+   else
+   {
+      ready           = bench->nextLoad;
+      msg->msgId      = bench_random(bench) & 0x7FF;
+      msg->header.len = BENCH_LOAD_LENGTH;
+      if(PDC_CAN_ID == msg->msgId)
+      {
+         msg->msgId = 0;
+      }
+      bench_schedule_load(bench);
+      ++bench->loadFrames;
+   }
+
+   // frames cannot overlap on the bus
+   bench->busFree += replay_frame_cycles(bench->bitrate, false, msg->header.len);
+   if(ready > bench->busFree)
+   {
+      bench->busFree = ready;
+   }
+   *at = bench->busFree;
+   return true;
+}
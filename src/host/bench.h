@@ -0,0 +1,99 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file bench.h
+ *
+ * Synthetic bus traffic for the latency benchmark: PDC frames with changing
+ * distances at a fixed period and other frames loading the bus. Distances
+ * may be replaced by random outliers to benchmark the filter.
+ *
+ * \date Created: 16.10.2026 22:58:58
+ * \author agent
+ **/
+
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "can/can_mcp2515.h"
+
+/**
+ * \brief state of the traffic generator
+ */
+typedef struct
+{
+   //! bitrate of the bus in bit/s
+   uint32_t bitrate;
+   //! period of PDC frames in cycles
+   uint64_t period;
+   //! bus load of other frames in percent
+   uint8_t  load;
+   //! time of the first frame
+   uint64_t start;
+   //! cycles the car drives each cycle, 0 drives all the time
+   uint64_t drive;
+   //! cycles the car is parked each cycle (bus silent)
+   uint64_t park;
+   //! distances replaced by outliers in percent
+   uint8_t  noise;
+   //! time of next PDC frame
+   uint64_t nextPdc;
+   //! time of next other frame
+   uint64_t nextLoad;
+   //! virtual time the bus is free again
+   uint64_t busFree;
+   //! state of the pseudo random generator
+   uint32_t random;
+   //! PDC frames generated
+   uint32_t pdcFrames;
+   //! other frames generated
+   uint32_t loadFrames;
+} bench_t;
+
+/**
+ * \brief init traffic generator
+ * \param bench state to init
+ * \param bitrate of the bus in bit/s
+ * \param periodMs period of PDC frames in ms
+ * \param load bus load of other frames in percent
+ * \param noise distances replaced by outliers in percent
+ * \param start virtual time of the first frame
+ */
+void bench_init(bench_t* bench, uint32_t bitrate, uint16_t periodMs,
+                uint8_t load, uint8_t noise, uint64_t start);
+
+/**
+ * \brief let the car drive and park in turns
+ *
+ * No frames are sent while parked, so the bus sleeps and wakes up again by
+ * the first frame of the next drive.
+ *
+ * \param bench generator state
+ * \param driveMs time driving each cycle in ms, 0 drives all the time
+ * \param parkMs time parked each cycle in ms
+ */
+void bench_set_cycle(bench_t* bench, uint32_t driveMs, uint32_t parkMs);
+
+/**
+ * \brief get next frame (host_can_source_t)
+ * \param context generator state
+ * \param at virtual time of reception
+ * \param msg frame to fill
+ * \return always true
+ */
+bool bench_next(void* context, uint64_t* at, can_t* msg);
+
+#endif /* BENCH_H_ */
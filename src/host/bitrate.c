@@ -0,0 +1,58 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file bitrate.c
+ *
+ * \date Created: 16.10.2026 23:27:30
+ * \author agent
+ **/
+
+
+#include "bitrate.h"
+
+//! bit/s in order of eCanBitRate
+static const uint32_t bitrates[NUM_OF_CAN_BITRATES] =
+{
+   100000UL,   // CAN_BITRATE_100_KBPS
+   125000UL,   // CAN_BITRATE_125_KBPS
+    50000UL,   // CAN_BITRATE_50_KBPS
+    83333UL,   // CAN_BITRATE_83_KBPS
+   250000UL,   // CAN_BITRATE_250_KBPS
+    20000UL,   // CAN_BITRATE_20_KBPS
+    33333UL    // CAN_BITRATE_33_KBPS
+};
+
+uint32_t host_bitrate(eCanBitRate index)
+{
+   return bitrates[index];
+}
+
+unsigned long host_bitrate_kbps(eCanBitRate index)
+{
+   return bitrates[index] / 1000UL;
+}
+
+bool host_bitrate_find(unsigned long kbps, eCanBitRate* index)
+{
+   uint8_t i;
+
+   for(i = 0; i < NUM_OF_CAN_BITRATES; ++i)
+   {
+      if(host_bitrate_kbps((eCanBitRate)i) == kbps)
+      {
+         *index = (eCanBitRate)i;
+         return true;
+      }
+   }
+   return false;
+}
@@ -0,0 +1,54 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file bitrate.h
+ *
+ * Bitrates of the mcp2515_cnf table in bit/s, as given on the command line
+ * of the host tools.
+ *
+ * \date Created: 16.10.2026 23:27:30
+ * \author agent
+ **/
+
+
+#ifndef BITRATE_H_
+#define BITRATE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "config/can_config_mcp2515.h"
+
+/**
+ * \brief get bitrate in bit/s
+ * \param index of mcp2515_cnf table
+ * \return bit/s
+ */
+uint32_t host_bitrate(eCanBitRate index);
+
+/**
+ * \brief get bitrate in kbit/s as given on the command line
+ * \param index of mcp2515_cnf table
+ * \return kbit/s, 83 and 33 for 83.3 and 33.3
+ */
+unsigned long host_bitrate_kbps(eCanBitRate index);
+
+/**
+ * \brief find bitrate given on the command line
+ * \param kbps kbit/s
+ * \param index of mcp2515_cnf table found
+ * \return false, if there is no setup of the MCP2515
+ */
+bool host_bitrate_find(unsigned long kbps, eCanBitRate* index);
+
+#endif /* BITRATE_H_ */
@@ -0,0 +1,251 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file can/can_mcp2515.h
+ *
+ * Host stub of the can module. The MCP2515 is simulated on register level
+ * including receive buffers, masks and filters.
+ *
+ * \date Created: 16.10.2026 22:46:35
+ * \author agent
+ **/
+
+
+#ifndef CAN_MCP2515_H_
+#define CAN_MCP2515_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "config/can_config_mcp2515.h"
+#include "spi/spi.h"
+
+// === MCP2515 REGISTERS =====================================================
+
+#define RXF0SIDH     0x00
+#define RXF1SIDH     0x04
+#define RXF2SIDH     0x08
+#define BFPCTRL      0x0C
+#define TXRTSCTRL    0x0D
+#define CANSTAT      0x0E
+#define CANCTRL      0x0F
+#define RXF3SIDH     0x10
+#define RXF4SIDH     0x14
+#define RXF5SIDH     0x18
+#define TEC          0x1C
+#define REC          0x1D
+#define RXM0SIDH     0x20
+#define RXM1SIDH     0x24
+#define CNF3         0x28
+#define CNF2         0x29
+#define CNF1         0x2A
+#define CANINTE      0x2B
+#define CANINTF      0x2C
+#define EFLG         0x2D
+#define RXB0CTRL     0x60
+#define RXB0SIDH     0x61
+#define RXB1CTRL     0x70
+#define RXB1SIDH     0x71
+
+// CANINTE/CANINTF
+#define RX0IE        0
+#define RX1IE        1
+#define ERRIE        5
+#define WAKIE        6
+#define RX0IF        0
+#define RX1IF        1
+#define ERRIF        5
+#define WAKIF        6
+#define MERRF        7
+
+// EFLG
+#define RX0OVR       6
+#define RX1OVR       7
+
+// RXB0CTRL
+#define BUKT         2
+
+// SIDL
+#define EXIDE        3
+
+//! length of filter/mask setup (SIDH, SIDL, EID8, EID0)
+#define MAX_LENGTH_OF_FILTER_SETUP  4
+
+// === TYPES =================================================================
+
+/**
+ * \brief operation modes of the MCP2515 (REQOP bits of CANCTRL)
+ */
+typedef enum
+{
+   NORMAL_MODE       = 0x00,
+   SLEEP_MODE        = 0x20,
+   LOOPBACK_MODE     = 0x40,
+   LISTEN_ONLY_MODE  = 0x60,
+   CONFIG_MODE       = 0x80
+} eCanMode;
+
+/**
+ * \brief interrupt setup when going to sleep
+ */
+typedef enum
+{
+   INT_SLEEP_NO_WAKEUP     = 0,
+   INT_SLEEP_WAKEUP_BY_CAN = 1
+} eInterruptSleep;
+
+/**
+ * \brief CAN message
+ */
+typedef struct
+{
+   //! CAN id (11bit)
+   uint32_t msgId;
+   //! header information
+   struct
+   {
+      //! remote transmit request
+      unsigned int rtr : 1;
+      //! data length code
+      unsigned int len : 4;
+   } header;
+   //! data bytes
+   uint8_t data[8];
+} can_t;
+
+// === MODULE API ============================================================
+
+bool can_init_mcp2515(eChipSelect chip, eCanBitRate bitrate, eCanMode mode);
+void set_mode_mcp2515(eChipSelect chip, eCanMode mode);
+void setFilters(eChipSelect chip, uint8_t address, uint8_t* data);
+bool can_check_message_received(eChipSelect chip);
+bool can_get_message(eChipSelect chip, can_t* msg);
+void mcp2515_sleep(eChipSelect chip, eInterruptSleep intCtrl);
+void mcp2515_wakeup(eChipSelect chip, eInterruptSleep intCtrl);
+
+uint8_t read_register_mcp2515(eChipSelect chip, uint8_t address);
+void write_register_mcp2515(eChipSelect chip, uint8_t address, uint8_t data);
+void bit_modify_mcp2515(eChipSelect chip, uint8_t address, uint8_t mask, uint8_t data);
+
+// === SIMULATION ============================================================
+
+/**
+ * \brief source of frames for the simulated bus
+ *
+ * Called whenever the bus queue has space left. Frames must be given in
+ * order of their time of reception.
+ *
+ * \param context of the source
+ * \param at virtual time of reception
+ * \param msg frame to fill
+ * \return false, if the source is exhausted
+ */
+typedef bool (*host_can_source_t)(void* context, uint64_t* at, can_t* msg);
+
+/**
+ * \brief put frame on the simulated bus of a controller
+ * \param chip controller connected to the bus
+ * \param at virtual time of reception
+ * \param msg frame
+ * \return false, if the bus queue is full
+ */
+bool host_can_push(eChipSelect chip, uint64_t at, const can_t* msg);
+
+/**
+ * \brief put frame on the simulated bus out of the order of the queue
+ *
+ * Received in the order of time with the frames of the queue, e.g. to hit
+ * a window of the FSM found at run time. Only one frame at a time.
+ *
+ * \param chip controller connected to the bus
+ * \param at virtual time of reception
+ * \param msg frame
+ * \return false, if the frame injected before is not received yet
+ */
+bool host_can_inject(eChipSelect chip, uint64_t at, const can_t* msg);
+
+/**
+ * \brief attach a source streaming frames onto the simulated bus
+ * \param chip controller connected to the bus
+ * \param source to pull frames from or NULL
+ * \param context given to the source
+ */
+void host_can_set_source(eChipSelect chip, host_can_source_t source, void* context);
+
+/**
+ * \brief get time of reception of the frame read last from a receive buffer
+ * \return virtual time the frame was stored in the buffer
+ */
+uint64_t host_can_rx_time(void);
+
+/**
+ * \brief set bitrate used on the simulated bus
+ * \param chip controller connected to the bus
+ * \param bitrate of bus
+ */
+void host_can_set_bitrate(eChipSelect chip, eCanBitRate bitrate);
+
+/**
+ * \brief chip select of a simulated controller
+ * \param chip controller
+ * \param active true to select (CS low), false to release
+ */
+void host_can_chip_select(eChipSelect chip, bool active);
+
+/**
+ * \brief transfer one byte via SPI to the selected controller
+ * \param data byte sent
+ * \return byte received
+ */
+uint8_t host_can_spi_transfer(uint8_t data);
+
+/**
+ * \brief get number of bytes transferred via SPI
+ * \return bytes since start
+ */
+uint32_t host_can_spi_bytes(void);
+
+/**
+ * \brief let the controller lose its configuration when woken up
+ *
+ * Simulates a reset by undervoltage while cranking right after the wake up
+ * interrupt: all registers but the wake up interrupt are cleared and the
+ * controller is in configuration mode.
+ *
+ * \param chip controller
+ * \param reset true to lose the configuration on each wake up
+ */
+void host_can_reset_on_wake(eChipSelect chip, bool reset);
+
+/**
+ * \brief let the controller not answer via SPI, so can_init_mcp2515() fails
+ * \param chip controller
+ * \param missing true to simulate a controller not soldered or broken
+ */
+void host_can_set_missing(eChipSelect chip, bool missing);
+
+/**
+ * \brief frames lost in the controller due to receive buffer overflow
+ * \param chip controller
+ * \return number of frames
+ */
+uint32_t host_can_lost(eChipSelect chip);
+
+/**
+ * \brief frames passing the filters of the controller, lost or not
+ * \param chip controller
+ * \return number of frames
+ */
+uint32_t host_can_accepted(eChipSelect chip);
+
+#endif /* CAN_MCP2515_H_ */
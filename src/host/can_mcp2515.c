@@ -0,0 +1,762 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file can_mcp2515.c
+ *
+ * Host stub of the can module. Each MCP2515 is simulated by its register
+ * file. Frames put on the simulated bus pass the masks and filters and are
+ * stored in the receive buffers like the real controller does.
+ *
+ * \date Created: 16.10.2026 22:46:35
+ * \author agent
+ **/
+
+
+#include <string.h>
+
+#include "hal.h"
+#include "can/can_mcp2515.h"
+
+// === DEFINITIONS ===========================================================
+
+//! size of the bus queue per controller (2^n)
+#define HOST_CAN_QUEUE_SIZE   256
+
+//! mode bits of CANSTAT/CANCTRL
+#define HOST_CAN_MODE_MASK    0xE0
+
+//! no controller selected
+#define HOST_CAN_NONE         0xFF
+
+/**
+ * \brief SPI instructions of the MCP2515
+ */
+enum
+{
+   HOST_SPI_WRITE       = 0x02,
+   HOST_SPI_READ        = 0x03,
+   HOST_SPI_BIT_MODIFY  = 0x05,
+   HOST_SPI_LOAD_TX     = 0x40,
+   HOST_SPI_RTS         = 0x80,
+   HOST_SPI_READ_RX     = 0x90,
+   HOST_SPI_READ_STATUS = 0xA0,
+   HOST_SPI_RX_STATUS   = 0xB0,
+   HOST_SPI_RESET       = 0xC0
+};
+
+/**
+ * \brief frame on the simulated bus
+ */
+typedef struct
+{
+   //! virtual time of reception
+   uint64_t at;
+   //! frame
+   can_t    msg;
+} host_frame_t;
+
+/**
+ * \brief simulated MCP2515 and its bus
+ */
+typedef struct
+{
+   //! register file
+   uint8_t           regs[128];
+   //! bitrate configured for the bus
+   eCanBitRate       busBitrate;
+   //! frames passing the filters
+   uint32_t          accepted;
+   //! frames lost due to full receive buffers
+   uint32_t          lost;
+   //! time of reception of the frames in the receive buffers
+   uint64_t          rxAt[2];
+   //! configuration is lost on wake up
+   bool              resetOnWake;
+   //! not answering via SPI, e.g. not soldered
+   bool              missing;
+   //! source of frames or NULL
+   host_can_source_t source;
+   //! context of source
+   void*             context;
+   //! bus queue
+   host_frame_t      queue[HOST_CAN_QUEUE_SIZE];
+   //! queue read index
+   uint16_t          head;
+   //! queue write index
+   uint16_t          tail;
+   //! frame put on the bus out of the order of the queue
+   host_frame_t      injected;
+   //! injected frame not received yet
+   bool              pending;
+   //! current SPI instruction
+   uint8_t           instruction;
+   //! bytes transferred since chip select
+   uint8_t           count;
+   //! register address used by the instruction
+   uint8_t           address;
+   //! mask of bit modify instruction
+   uint8_t           mask;
+} host_mcp2515_t;
+
+//! all simulated controllers
+static host_mcp2515_t mcp[NUM_OF_MCP2515];
+
+//! controller selected for SPI
+static uint8_t selected = HOST_CAN_NONE;
+
+//! bytes transferred via SPI
+static uint32_t spiBytes = 0;
+
+//! time of reception of the frame read last
+static uint64_t rxTime = 0;
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief get standard id from a filter or mask setup
+ * \param regs register file
+ * \param address of SIDH
+ * \return 11bit id
+ */
+static uint16_t host_can_sid(const uint8_t* regs, uint8_t address)
+{
+   return (uint16_t)((regs[address] << 3) | (regs[address + 1] >> 5));
+}
+
+/**
+ * \brief check frame against a mask and filter
+ *
+ * EID8 and EID0 of mask and filter apply to the data bytes 0 and 1 of
+ * standard frames like on the MCP2515.
+ *
+ * \param regs register file
+ * \param mask address of mask SIDH
+ * \param filter address of filter SIDH
+ * \param msg frame
+ * \return true, if accepted
+ */
+static bool host_can_match(const uint8_t* regs, uint8_t mask, uint8_t filter, const can_t* msg)
+{
+   uint16_t id = (uint16_t)(msg->msgId & 0x7FF);
+
+   return (0 == (regs[filter + 1] & (1 << EXIDE))) &&
+          (0 == ((id ^ host_can_sid(regs, filter)) & host_can_sid(regs, mask))) &&
+          (0 == ((msg->data[0] ^ regs[filter + 2]) & regs[mask + 2])) &&
+          (0 == ((msg->data[1] ^ regs[filter + 3]) & regs[mask + 3]));
+}
+
+/**
+ * \brief write a register
+ *
+ * The requested mode is taken over immediately.
+ *
+ * \param c controller
+ * \param address of register
+ * \param data to write
+ */
+static void host_can_write(host_mcp2515_t* c, uint8_t address, uint8_t data)
+{
+   address &= 0x7F;
+   c->regs[address] = data;
+   if(CANCTRL == address)
+   {
+      c->regs[CANSTAT] = (c->regs[CANSTAT] & ~HOST_CAN_MODE_MASK) |
+                         (data & HOST_CAN_MODE_MASK);
+   }
+}
+
+/**
+ * \brief check bit timing of controller against the bus
+ * \param c controller
+ * \return true, if frames can be received
+ */
+static bool host_can_bitrate_ok(const host_mcp2515_t* c)
+{
+   const uint8_t* cnf = getCanConfiguration(c->busBitrate);
+
+   return (c->regs[CNF1] == cnf[0]) &&
+          (c->regs[CNF2] == cnf[1]) &&
+          ((c->regs[CNF3] & 0x07) == (cnf[2] & 0x07));
+}
+
+/**
+ * \brief store frame in a receive buffer
+ * \param c controller
+ * \param buffer 0 or 1
+ * \param frame from bus
+ * \return false, if buffer is full
+ */
+static bool host_can_store(host_mcp2515_t* c, uint8_t buffer, const host_frame_t* frame)
+{
+   const can_t* msg = &frame->msg;
+
+   uint8_t* rxb = &c->regs[buffer ? RXB1SIDH : RXB0SIDH];
+
+   if(c->regs[CANINTF] & (1 << (RX0IF + buffer)))
+   {
+      c->regs[EFLG]    |= (uint8_t)(1 << (RX0OVR + buffer));
+      c->regs[CANINTF] |= (1 << ERRIF);
+      return false;
+   }
+
+   rxb[0] = (uint8_t)(msg->msgId >> 3);
+   rxb[1] = (uint8_t)((msg->msgId << 5) | (msg->header.rtr ? 0x10 : 0x00));
+   rxb[2] = 0;
+   rxb[3] = 0;
+   rxb[4] = (uint8_t)(msg->header.len | (msg->header.rtr ? 0x40 : 0x00));
+   memcpy(&rxb[5], msg->data, sizeof(msg->data));
+   c->rxAt[buffer]   = frame->at;
+   c->regs[CANINTF] |= (uint8_t)(1 << (RX0IF + buffer));
+   return true;
+}
+
+/**
+ * \brief receive a frame from the bus
+ * \param c controller
+ * \param frame from bus
+ */
+static void host_can_receive(host_mcp2515_t* c, const host_frame_t* frame)
+{
+   uint8_t  mode = c->regs[CANSTAT] & HOST_CAN_MODE_MASK;
+   bool     rxb0;
+   bool     rxb1;
+   bool     ok   = true;
+
+   if(SLEEP_MODE == mode)
+   {
+      // frame is lost, but bus activity wakes up the controller
+      if(c->regs[CANINTE] & (1 << WAKIE))
+      {
+         c->regs[CANINTF] |= (1 << WAKIF);
+      }
+      c->regs[CANSTAT] = (c->regs[CANSTAT] & ~HOST_CAN_MODE_MASK) | LISTEN_ONLY_MODE;
+      c->regs[CANCTRL] = (c->regs[CANCTRL] & ~HOST_CAN_MODE_MASK) | LISTEN_ONLY_MODE;
+
+      if(c->resetOnWake)
+      {
+         memset(c->regs, 0, sizeof(c->regs));
+         c->regs[CANINTE] = (1 << WAKIE);
+         c->regs[CANINTF] = (1 << WAKIF);
+         c->regs[CANSTAT] = CONFIG_MODE;
+         c->regs[CANCTRL] = CONFIG_MODE;
+      }
+      return;
+   }
+
+   if(CONFIG_MODE == mode)
+   {
+      return;
+   }
+
+   if(!host_can_bitrate_ok(c))
+   {
+      // bit errors while sampling at the wrong rate
+      c->regs[CANINTF] |= (1 << MERRF);
+      return;
+   }
+
+   rxb0 = host_can_match(c->regs, RXM0SIDH, RXF0SIDH, &frame->msg) ||
+          host_can_match(c->regs, RXM0SIDH, RXF1SIDH, &frame->msg);
+   rxb1 = host_can_match(c->regs, RXM1SIDH, RXF2SIDH, &frame->msg) ||
+          host_can_match(c->regs, RXM1SIDH, RXF3SIDH, &frame->msg) ||
+          host_can_match(c->regs, RXM1SIDH, RXF4SIDH, &frame->msg) ||
+          host_can_match(c->regs, RXM1SIDH, RXF5SIDH, &frame->msg);
+
+   if(rxb0 || rxb1)
+   {
+      ++c->accepted;
+   }
+
+   if(rxb0)
+   {
+      if((c->regs[CANINTF] & (1 << RX0IF)) && (c->regs[RXB0CTRL] & (1 << BUKT)))
+      {
+         // rollover
+         ok = host_can_store(c, 1, frame);
+      }
+      else
+      {
+         ok = host_can_store(c, 0, frame);
+      }
+   }
+   else if(rxb1)
+   {
+      ok = host_can_store(c, 1, frame);
+   }
+
+   if(!ok)
+   {
+      ++c->lost;
+   }
+}
+
+/**
+ * \brief fill bus queue from the source of a controller
+ * \param c controller
+ */
+static void host_can_fill(host_mcp2515_t* c)
+{
+   uint16_t next;
+
+   while(NULL != c->source)
+   {
+      next = (c->tail + 1) & (HOST_CAN_QUEUE_SIZE - 1);
+      if(next == c->head)
+      {
+         break;
+      }
+      if(!c->source(c->context, &c->queue[c->tail].at, &c->queue[c->tail].msg))
+      {
+         c->source = NULL;
+         break;
+      }
+      c->tail = next;
+   }
+}
+
+// === MODULE API ============================================================
+//
+// The functions access the simulated controller via SPI like the can module
+// does, so the transferred bytes are counted.
+
+/**
+ * \brief start SPI instruction
+ * \param chip controller
+ * \param instruction to send
+ */
+static void host_can_begin(eChipSelect chip, uint8_t instruction)
+{
+   host_can_chip_select(chip, true);
+   spi_putc(instruction);
+}
+
+/**
+ * \brief end SPI instruction
+ * \param chip controller
+ */
+static void host_can_end(eChipSelect chip)
+{
+   host_can_chip_select(chip, false);
+}
+
+bool can_init_mcp2515(eChipSelect chip, eCanBitRate bitrate, eCanMode mode)
+{
+   uint8_t* cnf = getCanConfiguration(bitrate);
+
+   host_can_begin(chip, HOST_SPI_RESET);
+   host_can_end(chip);
+
+   // CNF3, CNF2, CNF1, CANINTE
+   host_can_begin(chip, HOST_SPI_WRITE);
+   spi_putc(CNF3);
+   spi_putc(cnf[2]);
+   spi_putc(cnf[1]);
+   spi_putc(cnf[0]);
+   spi_putc((1 << RX0IE) | (1 << RX1IE));
+   host_can_end(chip);
+
+   // the controller is accessible, if the configuration is read back
+   if(read_register_mcp2515(chip, CNF1) != cnf[0])
+   {
+      return false;
+   }
+
+   set_mode_mcp2515(chip, mode);
+
+   return true;
+}
+
+void set_mode_mcp2515(eChipSelect chip, eCanMode mode)
+{
+   bit_modify_mcp2515(chip, CANCTRL, HOST_CAN_MODE_MASK, mode);
+}
+
+void setFilters(eChipSelect chip, uint8_t address, uint8_t* data)
+{
+   uint8_t i;
+
+   host_can_begin(chip, HOST_SPI_WRITE);
+   spi_putc(address);
+   for(i = 0; i < MAX_LENGTH_OF_FILTER_SETUP; ++i)
+   {
+      spi_putc(data[i]);
+   }
+   host_can_end(chip);
+}
+
+bool can_check_message_received(eChipSelect chip)
+{
+   // INT pin, no SPI access needed
+   host_mcp2515_t* c = &mcp[chip];
+
+   return (0 != (c->regs[CANINTF] & c->regs[CANINTE]));
+}
+
+bool can_get_message(eChipSelect chip, can_t* msg)
+{
+   uint8_t status;
+   uint8_t buffer;
+   uint8_t sidl;
+   uint8_t dlc;
+   uint8_t i;
+
+   host_can_begin(chip, HOST_SPI_READ_STATUS);
+   status = spi_putc(0xFF);
+   host_can_end(chip);
+
+   if(status & (1 << RX0IF))
+   {
+      buffer = 0;
+   }
+   else if(status & (1 << RX1IF))
+   {
+      buffer = 1;
+   }
+   else
+   {
+      return false;
+   }
+
+   host_can_begin(chip, HOST_SPI_READ);
+   spi_putc(buffer ? RXB1SIDH : RXB0SIDH);
+   msg->msgId      = (uint32_t)spi_putc(0xFF) << 3;
+   sidl            = spi_putc(0xFF);
+   msg->msgId     |= sidl >> 5;
+   msg->header.rtr = (sidl & 0x10) ? 1 : 0;
+   spi_putc(0xFF);
+   spi_putc(0xFF);
+   dlc             = spi_putc(0xFF);
+   msg->header.len = dlc & 0x0F;
+   for(i = 0; i < 8; ++i)
+   {
+      msg->data[i] = spi_putc(0xFF);
+   }
+   host_can_end(chip);
+
+   bit_modify_mcp2515(chip, CANINTF, (uint8_t)(1 << (RX0IF + buffer)), 0);
+
+   return true;
+}
+
+void mcp2515_sleep(eChipSelect chip, eInterruptSleep intCtrl)
+{
+   if(INT_SLEEP_WAKEUP_BY_CAN == intCtrl)
+   {
+      bit_modify_mcp2515(chip, CANINTE, (1 << WAKIE), (1 << WAKIE));
+   }
+   bit_modify_mcp2515(chip, CANINTF, (1 << WAKIF), 0);
+   set_mode_mcp2515(chip, SLEEP_MODE);
+}
+
+void mcp2515_wakeup(eChipSelect chip, eInterruptSleep intCtrl)
+{
+   if(INT_SLEEP_WAKEUP_BY_CAN == intCtrl)
+   {
+      bit_modify_mcp2515(chip, CANINTE, (1 << WAKIE), 0);
+   }
+   bit_modify_mcp2515(chip, CANINTF, (1 << WAKIF), 0);
+   set_mode_mcp2515(chip, LISTEN_ONLY_MODE);
+}
+
+uint8_t read_register_mcp2515(eChipSelect chip, uint8_t address)
+{
+   uint8_t data;
+
+   host_can_begin(chip, HOST_SPI_READ);
+   spi_putc(address);
+   data = spi_putc(0xFF);
+   host_can_end(chip);
+
+   return data;
+}
+
+void write_register_mcp2515(eChipSelect chip, uint8_t address, uint8_t data)
+{
+   host_can_begin(chip, HOST_SPI_WRITE);
+   spi_putc(address);
+   spi_putc(data);
+   host_can_end(chip);
+}
+
+void bit_modify_mcp2515(eChipSelect chip, uint8_t address, uint8_t mask, uint8_t data)
+{
+   host_can_begin(chip, HOST_SPI_BIT_MODIFY);
+   spi_putc(address);
+   spi_putc(mask);
+   spi_putc(data);
+   host_can_end(chip);
+}
+
+// === SIMULATION ============================================================
+
+bool host_can_push(eChipSelect chip, uint64_t at, const can_t* msg)
+{
+   host_mcp2515_t* c    = &mcp[chip];
+   uint16_t        next = (c->tail + 1) & (HOST_CAN_QUEUE_SIZE - 1);
+
+   if(next == c->head)
+   {
+      return false;
+   }
+   c->queue[c->tail].at  = at;
+   c->queue[c->tail].msg = *msg;
+   c->tail = next;
+   return true;
+}
+
+void host_can_set_source(eChipSelect chip, host_can_source_t source, void* context)
+{
+   mcp[chip].source  = source;
+   mcp[chip].context = context;
+}
+
+uint64_t host_can_rx_time(void)
+{
+   return rxTime;
+}
+
+void host_can_set_bitrate(eChipSelect chip, eCanBitRate bitrate)
+{
+   mcp[chip].busBitrate = bitrate;
+}
+
+void host_can_reset_on_wake(eChipSelect chip, bool reset)
+{
+   mcp[chip].resetOnWake = reset;
+}
+
+bool host_can_inject(eChipSelect chip, uint64_t at, const can_t* msg)
+{
+   host_mcp2515_t* c = &mcp[chip];
+
+   if(c->pending)
+   {
+      return false;
+   }
+   c->injected.at  = at;
+   c->injected.msg = *msg;
+   c->pending      = true;
+   return true;
+}
+
+void host_can_set_missing(eChipSelect chip, bool missing)
+{
+   mcp[chip].missing = missing;
+}
+
+uint32_t host_can_lost(eChipSelect chip)
+{
+   return mcp[chip].lost;
+}
+
+uint32_t host_can_accepted(eChipSelect chip)
+{
+   return mcp[chip].accepted;
+}
+
+uint64_t host_can_next_event(void)
+{
+   uint64_t next = HOST_NO_EVENT;
+   uint8_t  i;
+
+   for(i = 0; i < NUM_OF_MCP2515; ++i)
+   {
+      host_can_fill(&mcp[i]);
+      if((mcp[i].head != mcp[i].tail) && (mcp[i].queue[mcp[i].head].at < next))
+      {
+         next = mcp[i].queue[mcp[i].head].at;
+      }
+      if(mcp[i].pending && (mcp[i].injected.at < next))
+      {
+         next = mcp[i].injected.at;
+      }
+   }
+   return next;
+}
+
+void host_can_update(void)
+{
+   host_mcp2515_t* c;
+   uint8_t         i;
+
+   for(i = 0; i < NUM_OF_MCP2515; ++i)
+   {
+      c = &mcp[i];
+      host_can_fill(c);
+      while(true)
+      {
+         // the injected frame takes its place in the order of time
+         if(c->pending && (c->injected.at <= hostCycles) &&
+            ((c->head == c->tail) || (c->injected.at <= c->queue[c->head].at)))
+         {
+            host_can_receive(c, &c->injected);
+            c->pending = false;
+         }
+         else if((c->head != c->tail) && (c->queue[c->head].at <= hostCycles))
+         {
+            host_can_receive(c, &c->queue[c->head]);
+            c->head = (c->head + 1) & (HOST_CAN_QUEUE_SIZE - 1);
+            host_can_fill(c);
+         }
+         else
+         {
+            break;
+         }
+      }
+   }
+}
+
+void host_can_chip_select(eChipSelect chip, bool active)
+{
+   host_mcp2515_t* c = &mcp[chip];
+
+   if(active)
+   {
+      selected       = chip;
+      c->count       = 0;
+      c->instruction = 0;
+      return;
+   }
+
+   // READ RX BUFFER clears the interrupt flag on release of CS
+   if(((c->instruction & 0xF9) == HOST_SPI_READ_RX) && (c->count > 1))
+   {
+      c->regs[CANINTF] &= (uint8_t)~(1 << (RX0IF + ((c->instruction >> 2) & 1)));
+   }
+   selected = HOST_CAN_NONE;
+}
+
+uint8_t host_can_spi_transfer(uint8_t data)
+{
+   host_mcp2515_t* c;
+   uint8_t         ret = 0xFF;
+   uint8_t         i;
+
+   ++spiBytes;
+   // MISO is pulled up, if no controller answers
+   if((HOST_CAN_NONE == selected) || mcp[selected].missing)
+   {
+      return ret;
+   }
+
+   c = &mcp[selected];
+   if(0 == c->count++)
+   {
+      c->instruction = data;
+      if(HOST_SPI_RESET == data)
+      {
+         memset(c->regs, 0, sizeof(c->regs));
+         c->regs[CANSTAT] = CONFIG_MODE;
+         c->regs[CANCTRL] = CONFIG_MODE;
+      }
+      else if((data & 0xF9) == HOST_SPI_READ_RX)
+      {
+         rxTime     = c->rxAt[(data >> 2) & 1];
+         c->address = ((data & 0x04) ? RXB1SIDH : RXB0SIDH) + ((data & 0x02) ? 5 : 0);
+      }
+      else if((data & 0xF8) == HOST_SPI_LOAD_TX)
+      {
+         // TXB0SIDH 0x31, TXB0D0 0x36, TXB1SIDH 0x41, ...
+         c->address = (uint8_t)(0x31 + ((data >> 1) & 0x03) * 0x10 + ((data & 0x01) ? 5 : 0));
+      }
+      return ret;
+   }
+
+   switch(c->instruction)
+   {
+      case HOST_SPI_READ:
+      case HOST_SPI_WRITE:
+      case HOST_SPI_BIT_MODIFY:
+      {
+         if(2 == c->count)
+         {
+            c->address = data;
+         }
+         else if(HOST_SPI_READ == c->instruction)
+         {
+            ret = c->regs[c->address++ & 0x7F];
+         }
+         else if(HOST_SPI_WRITE == c->instruction)
+         {
+            host_can_write(c, c->address++, data);
+         }
+         else if(3 == c->count)
+         {
+            c->mask = data;
+         }
+         else if(4 == c->count)
+         {
+            i = c->regs[c->address & 0x7F];
+            host_can_write(c, c->address, (uint8_t)((i & ~c->mask) | (data & c->mask)));
+         }
+         break;
+      }
+
+      case HOST_SPI_READ_STATUS:
+      {
+         // same status is repeated
+         ret = (uint8_t)(((c->regs[CANINTF] >> RX0IF) & 0x03) |
+                         ((c->regs[0x30] & 0x08) >> 1) | ((c->regs[CANINTF] & 0x04) << 1) |
+                         ((c->regs[0x40] & 0x08) << 1) | ((c->regs[CANINTF] & 0x08) << 2) |
+                         ((c->regs[0x50] & 0x08) << 3) | ((c->regs[CANINTF] & 0x10) << 3));
+         break;
+      }
+
+      case HOST_SPI_RX_STATUS:
+      {
+         ret = (uint8_t)((c->regs[CANINTF] & 0x03) << 6);
+         if(ret)
+         {
+            // type of last message, filter hit is not simulated
+            i   = (ret & 0x40) ? RXB0SIDH : RXB1SIDH;
+            ret = (uint8_t)(ret | ((c->regs[i + 1] & 0x10) ? 0x08 : 0x00));
+         }
+         break;
+      }
+
+      default:
+      {
+         if(((c->instruction & 0xF9) == HOST_SPI_READ_RX))
+         {
+            ret = c->regs[c->address++ & 0x7F];
+         }
+         else if((c->instruction & 0xF8) == HOST_SPI_LOAD_TX)
+         {
+            c->regs[c->address++ & 0x7F] = data;
+         }
+         break;
+      }
+   }
+
+   return ret;
+}
+
+uint32_t host_can_spi_bytes(void)
+{
+   return spiBytes;
+}
+
+bool host_can_int_active(void)
+{
+   uint8_t i;
+
+   // INT lines are wired-AND to INT0
+   for(i = 0; i < NUM_OF_MCP2515; ++i)
+   {
+      if(can_check_message_received((eChipSelect)i))
+      {
+         return true;
+      }
+   }
+   return false;
+}
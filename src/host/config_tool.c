@@ -0,0 +1,432 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file config_tool.c
+ *
+ * Generates and inspects EEPROM images holding the settings (see
+ * config_store.h). The image is accessed through the same functions the
+ * firmware uses, so settings changed are written to the next slot like
+ * the AVR does. Program the image with e.g.
+ *
+ * \code
+ * avrdude -c avrispmkII -p m8 -P usb -U eeprom:w:eeprom.bin:r
+ * \endcode
+ *
+ * \date Created: 16.10.2026 23:27:30
+ * \author agent
+ **/
+
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "hal.h"
+#include "config_store.h"
+#include "display.h"
+#include "sleep_policy.h"
+#include "bitrate.h"
+#include "filter_name.h"
+
+// === GLOBALS ===============================================================
+
+//! EEPROM image
+static uint8_t image[E2END + 1];
+
+// === EEPROM ================================================================
+//
+// Replaces the simulation of hal_host.c, which is not linked.
+
+uint8_t hal_eeprom_read(uint16_t addr)
+{
+   return image[addr & E2END];
+}
+
+void hal_eeprom_write(uint16_t addr, uint8_t value)
+{
+   image[addr & E2END] = value;
+}
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief print usage
+ * \param name of program
+ */
+static void usage(const char* name)
+{
+   fprintf(stderr,
+           "usage: %s [-r] [-s key=value]... image\n"
+           "  prints the slots and the settings of the EEPROM image, which is\n"
+           "  created, if missing\n"
+           "  -r              reset settings to the defaults\n"
+           "  -s key=value    change a setting:\n"
+           "                  id          CAN id of the PDC message, e.g. 0x54B\n"
+           "                  bitrate     20, 33, 50, 83, 100, 125, 250 (kbps) or auto\n"
+           "                  bitrate2    same for the bus of the second MCP2515\n"
+           "                  compare     compare value of Timer2 (display multiplexing)\n"
+           "                  brightness  0..%d\n"
+           "                  reverse     bargraph reversed 0 or 1\n"
+           "                  inverted    bargraph inverted 0 or 1\n"
+           "                  filter      none or median, ema, rate joined by '+'\n"
+           "                  pdc-shift, pdc-min, pdc-max (ms or never)\n"
+           "                  bus-shift, bus-min, bus-max (ms or never)\n"
+           "                              timeouts, see sleep_policy.h\n"
+           "                  stale       age of a sensor value blanked (ms or never)\n"
+           "Settings changed are saved to the next slot.\n",
+           name, DISPLAY_BRIGHTNESS_MAX);
+}
+
+/**
+ * \brief compare key of a setting
+ * \param arg key=value
+ * \param len of key given
+ * \param key to compare with
+ * \return true, if equal
+ */
+static bool key_is(const char* arg, size_t len, const char* key)
+{
+   return (strlen(key) == len) && (0 == strncmp(arg, key, len));
+}
+
+/**
+ * \brief convert ticks of Timer1 to ms (rounded)
+ * \param ticks of Timer1
+ * \return ms
+ */
+static unsigned long ticks_to_ms(uint16_t ticks)
+{
+   return (unsigned long)(((uint64_t)ticks * 1024UL * 1000UL + F_CPU / 2) / F_CPU);
+}
+
+/**
+ * \brief parse timeout
+ * \param value ms or "never"
+ * \param ticks of Timer1
+ * \return false, if invalid
+ */
+static bool parse_timeout(const char* value, uint16_t* ticks)
+{
+   char*         end;
+   unsigned long ms;
+
+   if(0 == strcmp(value, "never"))
+   {
+      *ticks = SLEEP_POLICY_NEVER;
+      return true;
+   }
+   ms = strtoul(value, &end, 0);
+   if(('\0' != *end) || (ms > ticks_to_ms(SLEEP_POLICY_NEVER - 1)))
+   {
+      return false;
+   }
+   *ticks = SLEEP_POLICY_MS(ms);
+   return true;
+}
+
+/**
+ * \brief parse bitrate
+ * \param value kbps or "auto"
+ * \param bitrate eCanBitRate or CONFIG_BITRATE_UNKNOWN
+ * \return false, if invalid
+ */
+static bool parse_bitrate(const char* value, uint8_t* bitrate)
+{
+   char*         end;
+   unsigned long kbps;
+   eCanBitRate   found;
+
+   if(0 == strcmp(value, "auto"))
+   {
+      *bitrate = CONFIG_BITRATE_UNKNOWN;
+      return true;
+   }
+   kbps = strtoul(value, &end, 0);
+   if(('\0' != *end) || !host_bitrate_find(kbps, &found))
+   {
+      return false;
+   }
+   *bitrate = (uint8_t)found;
+   return true;
+}
+
+/**
+ * \brief change a setting
+ * \param settings to change
+ * \param arg key=value
+ * \return false, if invalid
+ */
+static bool set_key(config_t* settings, const char* arg)
+{
+   const char*   value = strchr(arg, '=');
+   size_t        len;
+   unsigned long number;
+   char*         end;
+
+   if(NULL == value)
+   {
+      return false;
+   }
+   len    = (size_t)(value - arg);
+   ++value;
+   number = strtoul(value, &end, 0);
+
+   if(key_is(arg, len, "bitrate"))
+   {
+      return parse_bitrate(value, &settings->bitrate[0]);
+   }
+   if(key_is(arg, len, "bitrate2"))
+   {
+      return parse_bitrate(value, &settings->bitrate[1]);
+   }
+   if(key_is(arg, len, "filter"))
+   {
+      return host_filter_parse(value, &settings->filter);
+   }
+   if(key_is(arg, len, "pdc-min"))
+   {
+      return parse_timeout(value, &settings->pdcMin);
+   }
+   if(key_is(arg, len, "pdc-max"))
+   {
+      return parse_timeout(value, &settings->pdcMax);
+   }
+   if(key_is(arg, len, "bus-min"))
+   {
+      return parse_timeout(value, &settings->busMin);
+   }
+   if(key_is(arg, len, "bus-max"))
+   {
+      return parse_timeout(value, &settings->busMax);
+   }
+   if(key_is(arg, len, "stale"))
+   {
+      return parse_timeout(value, &settings->staleAge);
+   }
+
+   if(('\0' != *end) || ('\0' == *value))
+   {
+      return false;
+   }
+
+   if((key_is(arg, len, "id")) && (number <= 0x7FF))
+   {
+      settings->pdcCanId = (uint16_t)number;
+   }
+   else if((key_is(arg, len, "compare")) && (number > 0) && (number <= UINT8_MAX))
+   {
+      settings->timer2Compare = (uint8_t)number;
+   }
+   else if((key_is(arg, len, "brightness")) && (number <= DISPLAY_BRIGHTNESS_MAX))
+   {
+      settings->brightness = (uint8_t)number;
+   }
+   else if((key_is(arg, len, "reverse")) && (number <= 1))
+   {
+      settings->bargraph = (uint8_t)((settings->bargraph & ~CONFIG_BARGRAPH_REVERSE) |
+                                     (number ? CONFIG_BARGRAPH_REVERSE : 0));
+   }
+   else if((key_is(arg, len, "inverted")) && (number <= 1))
+   {
+      settings->bargraph = (uint8_t)((settings->bargraph & ~CONFIG_BARGRAPH_INVERTED) |
+                                     (number ? CONFIG_BARGRAPH_INVERTED : 0));
+   }
+   else if((key_is(arg, len, "pdc-shift")) && (number < 16))
+   {
+      settings->pdcShift = (uint8_t)number;
+   }
+   else if((key_is(arg, len, "bus-shift")) && (number < 16))
+   {
+      settings->busShift = (uint8_t)number;
+   }
+   else
+   {
+      return false;
+   }
+   return true;
+}
+
+/**
+ * \brief print a timeout
+ * \param name of setting
+ * \param ticks of Timer1
+ */
+static void print_timeout(const char* name, uint16_t ticks)
+{
+   if(SLEEP_POLICY_NEVER == ticks)
+   {
+      printf("  %-11s never\n", name);
+   }
+   else
+   {
+      printf("  %-11s %lu ms (%u ticks)\n", name, ticks_to_ms(ticks), ticks);
+   }
+}
+
+/**
+ * \brief print a bitrate
+ * \param name of setting
+ * \param bitrate eCanBitRate or CONFIG_BITRATE_UNKNOWN
+ */
+static void print_bitrate(const char* name, uint8_t bitrate)
+{
+   if(bitrate < NUM_OF_CAN_BITRATES)
+   {
+      printf("  %-11s %lu kbps\n", name, host_bitrate_kbps((eCanBitRate)bitrate));
+   }
+   else
+   {
+      printf("  %-11s auto\n", name);
+   }
+}
+
+/**
+ * \brief print the slots and the settings loaded
+ */
+static void print_image(void)
+{
+   const config_t* settings = config_get();
+   config_record_t record;
+   uint8_t         i;
+
+   for(i = 0; i < CONFIG_STORE_SLOTS; ++i)
+   {
+      printf("slot %u: ", i);
+      if(config_read_slot(i, &record))
+      {
+         printf("sequence %u\n", record.sequence);
+      }
+      else if(0xFF == record.version)
+      {
+         printf("erased\n");
+      }
+      else if(CONFIG_VERSION != record.version)
+      {
+         printf("version %u, ignored\n", record.version);
+      }
+      else
+      {
+         printf("sequence %u, CRC error\n", record.sequence);
+      }
+   }
+
+   if(CONFIG_NO_SLOT == config_slot())
+   {
+      printf("settings (defaults):\n");
+   }
+   else
+   {
+      printf("settings (slot %u):\n", config_slot());
+   }
+   printf("  %-11s 0x%03X\n", "id", settings->pdcCanId);
+   print_bitrate("bitrate", settings->bitrate[0]);
+   print_bitrate("bitrate2", settings->bitrate[1]);
+   printf("  %-11s %u\n", "compare", settings->timer2Compare);
+   printf("  %-11s %u\n", "brightness", settings->brightness);
+   printf("  %-11s %u\n", "reverse", (settings->bargraph & CONFIG_BARGRAPH_REVERSE) ? 1 : 0);
+   printf("  %-11s %u\n", "inverted", (settings->bargraph & CONFIG_BARGRAPH_INVERTED) ? 1 : 0);
+   printf("  %-11s %s\n", "filter", host_filter_name(settings->filter));
+   printf("  %-11s %u\n", "pdc-shift", settings->pdcShift);
+   print_timeout("pdc-min", settings->pdcMin);
+   print_timeout("pdc-max", settings->pdcMax);
+   printf("  %-11s %u\n", "bus-shift", settings->busShift);
+   print_timeout("bus-min", settings->busMin);
+   print_timeout("bus-max", settings->busMax);
+   print_timeout("stale", settings->staleAge);
+}
+
+// === MAIN ==================================================================
+
+int main(int argc, char** argv)
+{
+   config_t    settings;
+   bool        reset  = false;
+   bool        set    = false;
+   bool        exists = false;
+   const char* path;
+   FILE*       file;
+   int         opt;
+
+   memset(image, 0xFF, sizeof(image));
+
+   // the image is needed before the settings are changed
+   while(-1 != (opt = getopt(argc, argv, "rs:h")))
+   {
+      if('r' == opt)
+      {
+         reset = true;
+      }
+      else if('s' == opt)
+      {
+         set = true;
+      }
+      else
+      {
+         usage(argv[0]);
+         return EXIT_FAILURE;
+      }
+   }
+   if(optind + 1 != argc)
+   {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+   }
+   path = argv[optind];
+
+   file = fopen(path, "rb");
+   if(NULL != file)
+   {
+      exists = true;
+      (void)fread(image, 1, sizeof(image), file);
+      fclose(file);
+   }
+   else if(ENOENT != errno)
+   {
+      perror(path);
+      return EXIT_FAILURE;
+   }
+
+   config_load();
+   settings = *config_get();
+   if(reset)
+   {
+      config_defaults(&settings);
+   }
+
+   optind = 1;
+   while(set && (-1 != (opt = getopt(argc, argv, "rs:h"))))
+   {
+      if(('s' == opt) && !set_key(&settings, optarg))
+      {
+         fprintf(stderr, "invalid setting: %s\n", optarg);
+         return EXIT_FAILURE;
+      }
+   }
+
+   config_set(&settings);
+   if(config_save() || !exists)
+   {
+      file = fopen(path, "wb");
+      if((NULL == file) || (sizeof(image) != fwrite(image, 1, sizeof(image), file)) ||
+         (0 != fclose(file)))
+      {
+         perror(path);
+         return EXIT_FAILURE;
+      }
+   }
+
+   print_image();
+   return EXIT_SUCCESS;
+}
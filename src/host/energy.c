@@ -0,0 +1,122 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file energy.c
+ *
+ * \date Created: 16.10.2026 23:10:25
+ * \author agent
+ **/
+
+
+#include <stdio.h>
+
+#include "hal.h"
+#include "matrixbar/matrixbar.h"
+#include "energy.h"
+#include "PDCViewer.h"
+
+// === DEFINITIONS ===========================================================
+
+//! supply current of the ATmega8 (4MHz, 5V) while executing in uA
+#define ENERGY_MCU_ACTIVE_UA     5000.0
+
+//! supply current of the ATmega8 (4MHz, 5V) in idle mode in uA
+#define ENERGY_MCU_IDLE_UA       2000.0
+
+//! supply current of the ATmega8 (5V, WDT off) in power down mode in uA
+#define ENERGY_MCU_PWR_DOWN_UA   1.0
+
+//! supply current of the MCP2515 (5V) while operating in uA
+#define ENERGY_CAN_ACTIVE_UA     5000.0
+
+//! supply current of the MCP2515 (5V) in sleep mode in uA
+#define ENERGY_CAN_SLEEP_UA      1.0
+
+//! current of a single LED of the matrixbar while lit in uA
+#define ENERGY_LED_UA            10000.0
+
+//! microampere cycles per mAh
+#define ENERGY_UA_CYCLES_PER_MAH (1000.0 * 3600.0 * F_CPU)
+
+// === TABLES ================================================================
+
+/**
+ * \brief supply current of the MCP2515 in each state of the FSM
+ *
+ * It is set to sleep by sleepDetected() and woken up by wakeUp().
+ */
+static const double canCurrent[NUM_OF_STATES] =
+{
+   ENERGY_CAN_ACTIVE_UA,   // INIT
+   ENERGY_CAN_ACTIVE_UA,   // RUNNING
+   ENERGY_CAN_ACTIVE_UA,   // SLEEP_DETECTED
+   ENERGY_CAN_SLEEP_UA,    // SLEEPING
+   ENERGY_CAN_ACTIVE_UA,   // WAKEUP
+   ENERGY_CAN_ACTIVE_UA    // ERROR
+};
+
+//! names of the states
+static const char* const stateNames[NUM_OF_STATES] =
+{
+   "INIT", "RUNNING", "SLEEP_DETECTED", "SLEEPING", "WAKEUP", "ERROR"
+};
+
+// === FUNCTIONS =============================================================
+
+double energy_state_mah(uint8_t state)
+{
+   const host_residency_t* r = host_state_residency(state);
+   double active = (double)(r->total - r->idle - r->powerDown);
+
+   return (active * ENERGY_MCU_ACTIVE_UA +
+           (double)r->idle * ENERGY_MCU_IDLE_UA +
+           (double)r->powerDown * ENERGY_MCU_PWR_DOWN_UA +
+           (double)r->total * canCurrent[state]) / ENERGY_UA_CYCLES_PER_MAH;
+}
+
+double energy_led_mah(void)
+{
+   return (double)host_matrixbar_led_cycles() * ENERGY_LED_UA / ENERGY_UA_CYCLES_PER_MAH;
+}
+
+double energy_total_mah(void)
+{
+   double  mah = energy_led_mah();
+   uint8_t state;
+
+   for(state = 0; state < NUM_OF_STATES; ++state)
+   {
+      mah += energy_state_mah(state);
+   }
+   return mah;
+}
+
+void energy_print(void)
+{
+   double  hours = (double)hostCycles / F_CPU / 3600.0;
+   double  total = energy_total_mah();
+   uint8_t state;
+
+   printf("state              time ms  share       mAh\n");
+   for(state = 0; state < NUM_OF_STATES; ++state)
+   {
+      printf("%-15s %10llu %5.1f%% %9.5f\n", stateNames[state],
+             (unsigned long long)(host_state_residency(state)->total / HOST_CYCLES_PER_MS),
+             (0 != hostCycles) ? (100.0 * host_state_residency(state)->total / hostCycles) : 0.0,
+             energy_state_mah(state));
+   }
+   printf("LEDs                                  %9.5f\n", energy_led_mah());
+   printf("total           %10llu        %9.5f mAh, mean %.3f mA\n",
+          (unsigned long long)(hostCycles / HOST_CYCLES_PER_MS), total,
+          (hours > 0.0) ? (total / hours) : 0.0);
+}
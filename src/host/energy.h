@@ -0,0 +1,55 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file energy.h
+ *
+ * Converts the residency of the FSM states into the charge drawn from the
+ * battery. The MCU is accounted by its sleep mode, the MCP2515 by the state
+ * of the FSM and the matrixbar by the on-time of its LEDs. The CAN
+ * transceiver depends on the hardware and is not included.
+ *
+ * \date Created: 16.10.2026 23:10:25
+ * \author agent
+ **/
+
+
+#ifndef ENERGY_H_
+#define ENERGY_H_
+
+#include <stdint.h>
+
+/**
+ * \brief get charge drawn in a state up to now
+ * \param state of the FSM
+ * \return charge in mAh
+ */
+double energy_state_mah(uint8_t state);
+
+/**
+ * \brief get charge drawn by the LEDs of the matrixbar up to now
+ * \return charge in mAh
+ */
+double energy_led_mah(void);
+
+/**
+ * \brief get charge drawn in all states up to now (including LEDs)
+ * \return charge in mAh
+ */
+double energy_total_mah(void);
+
+/**
+ * \brief print residency and charge of all states
+ */
+void energy_print(void);
+
+#endif /* ENERGY_H_ */
@@ -0,0 +1,105 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file filter_name.c
+ *
+ * \date Created: 16.10.2026 23:30:47
+ * \author agent
+ **/
+
+
+#include <string.h>
+
+#include "pdc_filter.h"
+#include "filter_name.h"
+
+// === DEFINITIONS ===========================================================
+
+/**
+ * \brief name of a stage
+ */
+typedef struct
+{
+   //! stage
+   uint8_t     mode;
+   //! name on the command line
+   const char* name;
+} host_filter_stage_t;
+
+//! all stages in order of the filter
+static const host_filter_stage_t stages[] =
+{
+   { PDC_FILTER_MEDIAN, "median" },
+   { PDC_FILTER_EMA,    "ema"    },
+   { PDC_FILTER_RATE,   "rate"   }
+};
+
+//! number of stages
+#define HOST_FILTER_STAGES    (sizeof(stages) / sizeof(stages[0]))
+
+// === FUNCTIONS =============================================================
+
+bool host_filter_parse(const char* text, uint8_t* mode)
+{
+   size_t len;
+   size_t i;
+
+   *mode = PDC_FILTER_NONE;
+   if(0 == strcmp(text, "none"))
+   {
+      return true;
+   }
+
+   while('\0' != *text)
+   {
+      len = strcspn(text, "+");
+      for(i = 0; i < HOST_FILTER_STAGES; ++i)
+      {
+         if((strlen(stages[i].name) == len) && (0 == strncmp(text, stages[i].name, len)))
+         {
+            *mode |= stages[i].mode;
+            break;
+         }
+      }
+      if(HOST_FILTER_STAGES == i)
+      {
+         return false;
+      }
+      text += len;
+      if('+' == *text)
+      {
+         ++text;
+      }
+   }
+   return PDC_FILTER_NONE != *mode;
+}
+
+const char* host_filter_name(uint8_t mode)
+{
+   static char name[32];
+   size_t      i;
+
+   name[0] = '\0';
+   for(i = 0; i < HOST_FILTER_STAGES; ++i)
+   {
+      if(mode & stages[i].mode)
+      {
+         if('\0' != name[0])
+         {
+            strcat(name, "+");
+         }
+         strcat(name, stages[i].name);
+      }
+   }
+   return ('\0' != name[0]) ? name : "none";
+}
@@ -0,0 +1,45 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file filter_name.h
+ *
+ * Stages of the filter (see pdc_filter.h) as given on the command line of
+ * the host tools: "none" or the stages joined by '+', e.g. "median+ema".
+ *
+ * \date Created: 16.10.2026 23:30:47
+ * \author agent
+ **/
+
+
+#ifndef FILTER_NAME_H_
+#define FILTER_NAME_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * \brief parse stages given on the command line
+ * \param text e.g. "median+rate"
+ * \param mode stages found
+ * \return false, if a stage is unknown
+ */
+bool host_filter_parse(const char* text, uint8_t* mode);
+
+/**
+ * \brief get name of stages
+ * \param mode stages
+ * \return name, valid until the next call
+ */
+const char* host_filter_name(uint8_t mode);
+
+#endif /* FILTER_NAME_H_ */
@@ -0,0 +1,786 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file hal_host.c
+ *
+ * \date Created: 16.10.2026 22:46:35
+ * \author agent
+ **/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#include "hal.h"
+#include "can/can_mcp2515.h"
+#include "timer/timer.h"
+#include "PDCViewer.h"
+
+// === GLOBALS ===============================================================
+
+volatile uint8_t DDRB;
+volatile uint8_t PORTB;
+volatile uint8_t DDRC;
+volatile uint8_t PORTC;
+volatile uint8_t DDRD;
+volatile uint8_t PORTD;
+
+uint64_t hostCycles                 = 0;
+
+//! end of simulation
+static uint64_t hostEndCycles       = HOST_NO_EVENT;
+
+//! global interrupt flag (I bit of SREG)
+static bool hostIrqEnabled          = false;
+
+//! INT0 enabled (GICR)
+static bool hostInt0Enabled         = false;
+
+//! main loop passes
+static uint64_t hostLoopPasses      = 0;
+
+//! cycles spent sleeping
+static uint64_t hostSleepCycles     = 0;
+
+//! cycles spent in idle mode
+static uint64_t hostIdleCycles      = 0;
+
+//! calls of the interrupt service routines
+static uint64_t hostIsrCalls[HOST_NUM_OF_IRQS];
+
+//! SPI bytes transferred by the interrupt service routines
+static uint64_t hostIsrSpiBytes[HOST_NUM_OF_IRQS];
+
+//! frames read from the controllers
+static uint64_t hostRxFrames        = 0;
+
+/**
+ * \brief frame in flight between controller and decoder
+ */
+typedef struct
+{
+   //! location of the frame (FIFO slot)
+   const void* msg;
+   //! time of reception by the controller
+   uint64_t    at;
+} host_trace_t;
+
+//! maximum frames in flight (FIFO slots and discard buffer)
+#define HOST_TRACE_SLOTS    16
+
+//! frames in flight
+static host_trace_t hostTrace[HOST_TRACE_SLOTS];
+
+//! latencies of decoded frames
+static host_stats_t hostDecodeLatency;
+
+//! maximum columns of the matrixbar traced
+#define HOST_TRACE_COLUMNS  8
+
+//! reception of the oldest frame decoded, but not shown yet (per column)
+static uint64_t hostShownPending[HOST_TRACE_COLUMNS];
+
+//! column has a frame pending
+static bool hostShownValid[HOST_TRACE_COLUMNS];
+
+//! latencies until values are shown
+static host_stats_t hostDisplayLatency;
+
+//! state of the FSM, see hal_trace_state()
+static uint8_t hostState            = 0;
+
+//! virtual time accounted to the states
+static uint64_t hostStateSince      = 0;
+
+//! SPI bytes accounted to the states
+static uint32_t hostStateSpiBytes   = 0;
+
+//! time spent in the states
+static host_residency_t hostResidency[HOST_TRACE_STATES];
+
+//! called on entering a state of the FSM
+static host_state_hook_t hostStateHook = NULL;
+
+//! virtual time of the last wake up from power down
+static uint64_t hostWakeAt          = 0;
+
+//! no frame decoded since the last wake up
+static bool hostWakePending         = false;
+
+//! latencies from wake up to first frame decoded
+static host_stats_t hostWakeLatency;
+
+//! maximum sensors traced
+#define HOST_TRACE_SENSORS  8
+
+//! last value decoded per sensor
+static uint8_t hostLastRaw[HOST_TRACE_SENSORS];
+
+//! last value filtered per sensor
+static uint8_t hostLastShown[HOST_TRACE_SENSORS];
+
+//! sensor has values to compare with
+static bool hostLastValid[HOST_TRACE_SENSORS];
+
+//! changes of the sensor values
+static host_jitter_t hostJitter;
+
+//! EEPROM contents
+static uint8_t hostEeprom[E2END + 1];
+
+//! EEPROM was erased
+static bool hostEepromValid         = false;
+
+//! bytes written to the EEPROM
+static uint32_t hostEepromWrites    = 0;
+
+//! bytes read from the EEPROM
+static uint32_t hostEepromReads     = 0;
+
+//! EEPROM is accessed by the programmer
+static bool hostEepromProgram       = false;
+
+//! UART data register empty interrupt enabled (UDRIE)
+static bool hostUartIrqEnabled      = false;
+
+//! virtual cycles per byte (start, 8 data and stop bit)
+static uint64_t hostUartByteCycles  = 0;
+
+//! virtual time the data register is empty again
+static uint64_t hostUartEmptyAt     = 0;
+
+//! virtual time the last byte is shifted out
+static uint64_t hostUartSentAt      = 0;
+
+//! bytes sent via UART
+static uint64_t hostUartBytes       = 0;
+
+//! file receiving the bytes sent via UART
+static FILE* hostUartFile           = NULL;
+
+//! virtual time the debug dump is requested from
+static uint64_t hostDebugRequestAt  = UINT64_MAX;
+
+// === INTERRUPTS ============================================================
+
+/**
+ * \brief call a pending interrupt service routine
+ *
+ * The priority follows the vector table of the ATmega8. Only one ISR is
+ * called, since the AVR executes at least one instruction of the main
+ * program before the next one. Interrupts are disabled while the ISR runs
+ * and enabled on return (RETI). An ISR enabling interrupts is interrupted
+ * by the others like on the AVR, since SPI transfers take virtual time.
+ *
+ * \return true, if an ISR was called
+ */
+static bool host_service_irq(void)
+{
+   uint32_t   spiBytes = host_can_spi_bytes();
+   host_irq_t irq      = HOST_IRQ_INT0;
+   bool       called   = true;
+
+   if(!hostIrqEnabled)
+   {
+      return false;
+   }
+
+   hostIrqEnabled = false;
+   if(hostInt0Enabled && host_can_int_active())
+   {
+      INT0_vect();
+   }
+   else if(host_timer2_irq_take())
+   {
+      irq = HOST_IRQ_TIMER2;
+      TIMER2_COMP_vect();
+   }
+   else if(host_timer1_irq_take())
+   {
+      irq = HOST_IRQ_TIMER1;
+      TIMER1_CAPT_vect();
+   }
+   else if(hostUartIrqEnabled && (hostCycles >= hostUartEmptyAt))
+   {
+      irq = HOST_IRQ_UART;
+#ifdef DEBUG_CHANNEL
+      // telemetry.c or the ring of debug.c
+      USART_UDRE_vect();
+#endif
+   }
+   else
+   {
+      called = false;
+   }
+   hostIrqEnabled = true;
+
+   if(called)
+   {
+      ++hostIsrCalls[irq];
+      hostIsrSpiBytes[irq] += host_can_spi_bytes() - spiBytes;
+   }
+
+   return called;
+}
+
+/**
+ * \brief get next event of all peripherals
+ * \return virtual time of next event
+ */
+static uint64_t host_next_event(void)
+{
+   uint64_t next    = host_timer_next_event();
+   uint64_t nextCan = host_can_next_event();
+
+   if(nextCan < next)
+   {
+      next = nextCan;
+   }
+   // an interrupt pending already is not an event
+   if(hostUartIrqEnabled && (hostUartEmptyAt > hostCycles) && (hostUartEmptyAt < next))
+   {
+      next = hostUartEmptyAt;
+   }
+   return next;
+}
+
+/**
+ * \brief account virtual time up to now to the current state
+ */
+static void host_account_state(void)
+{
+   hostResidency[hostState].total    += hostCycles - hostStateSince;
+   hostResidency[hostState].spiBytes += host_can_spi_bytes() - hostStateSpiBytes;
+   hostStateSince    = hostCycles;
+   hostStateSpiBytes = host_can_spi_bytes();
+}
+
+/**
+ * \brief get EEPROM contents, erased (0xFF) on first use
+ * \return EEPROM
+ */
+static uint8_t* host_eeprom(void)
+{
+   if(!hostEepromValid)
+   {
+      memset(hostEeprom, 0xFF, sizeof(hostEeprom));
+      hostEepromValid = true;
+   }
+   return hostEeprom;
+}
+
+/**
+ * \brief let the UART take a byte written to the data register
+ *
+ * The shift register takes the byte after the one before is sent.
+ */
+static void host_uart_shift(void)
+{
+   uint64_t start = (hostUartSentAt > hostCycles) ? hostUartSentAt : hostCycles;
+
+   hostUartEmptyAt = start;
+   hostUartSentAt  = start + hostUartByteCycles;
+}
+
+/**
+ * \brief update all peripherals to current virtual time
+ */
+static void host_update(void)
+{
+   host_timer_update();
+   host_can_update();
+}
+
+// === SIMULATION ============================================================
+
+void host_set_end(uint64_t cycles)
+{
+   hostEndCycles = cycles;
+}
+
+void host_advance(uint64_t cycles)
+{
+   uint64_t target = hostCycles + cycles;
+   uint64_t next;
+
+   do
+   {
+      next = host_next_event();
+      hostCycles = (next < target) ? next : target;
+      host_update();
+      // a level triggered interrupt may stay active
+      while(host_service_irq() && (hostCycles < hostEndCycles))
+      {
+         host_update();
+      }
+   } while(hostCycles < target);
+}
+
+uint64_t host_loop_passes(void)
+{
+   return hostLoopPasses;
+}
+
+uint64_t host_isr_calls(host_irq_t irq)
+{
+   return hostIsrCalls[irq];
+}
+
+void host_set_state_hook(host_state_hook_t hook)
+{
+   hostStateHook = hook;
+}
+
+const host_residency_t* host_state_residency(uint8_t state)
+{
+   host_account_state();
+   return &hostResidency[state];
+}
+
+uint64_t host_isr_spi_bytes(host_irq_t irq)
+{
+   return hostIsrSpiBytes[irq];
+}
+
+uint64_t host_rx_frames(void)
+{
+   return hostRxFrames;
+}
+
+host_stats_t* host_decode_latency(void)
+{
+   return &hostDecodeLatency;
+}
+
+host_stats_t* host_wake_latency(void)
+{
+   return &hostWakeLatency;
+}
+
+host_stats_t* host_display_latency(void)
+{
+   return &hostDisplayLatency;
+}
+
+const host_jitter_t* host_jitter(void)
+{
+   return &hostJitter;
+}
+
+uint64_t host_sleep_cycles(void)
+{
+   return hostSleepCycles;
+}
+
+uint64_t host_idle_cycles(void)
+{
+   return hostIdleCycles;
+}
+
+bool host_eeprom_load(const char* path)
+{
+   uint8_t* eeprom = host_eeprom();
+   FILE*    file   = fopen(path, "rb");
+
+   if(NULL == file)
+   {
+      return (ENOENT == errno);
+   }
+   memset(eeprom, 0xFF, E2END + 1);
+   (void)fread(eeprom, 1, E2END + 1, file);
+   fclose(file);
+   return true;
+}
+
+bool host_eeprom_save(const char* path)
+{
+   FILE* file = fopen(path, "wb");
+   bool  ok;
+
+   if(NULL == file)
+   {
+      return false;
+   }
+   ok = (E2END + 1 == fwrite(host_eeprom(), 1, E2END + 1, file));
+   return (0 == fclose(file)) && ok;
+}
+
+void host_eeprom_program(bool enable)
+{
+   hostEepromProgram = enable;
+}
+
+uint32_t host_eeprom_writes(void)
+{
+   return hostEepromWrites;
+}
+
+uint32_t host_eeprom_reads(void)
+{
+   return hostEepromReads;
+}
+
+bool host_uart_open(const char* path)
+{
+   hostUartFile = fopen(path, "wb");
+   return (NULL != hostUartFile);
+}
+
+void host_uart_close(void)
+{
+   if(NULL != hostUartFile)
+   {
+      fclose(hostUartFile);
+      hostUartFile = NULL;
+   }
+}
+
+void host_uart_instant(void)
+{
+   hostUartByteCycles = 0;
+   hostUartEmptyAt    = hostCycles;
+   hostUartSentAt     = hostCycles;
+}
+
+uint64_t host_uart_bytes(void)
+{
+   return hostUartBytes;
+}
+
+uint64_t host_uart_byte_cycles(void)
+{
+   return hostUartByteCycles;
+}
+
+void host_debug_request(uint64_t cycles)
+{
+   hostDebugRequestAt = cycles;
+}
+
+// === HAL ===================================================================
+
+bool hal_running(void)
+{
+   ++hostLoopPasses;
+   host_advance(HOST_LOOP_CYCLES);
+   return (hostCycles < hostEndCycles);
+}
+
+void hal_irq_disable(void)
+{
+   hostIrqEnabled = false;
+}
+
+void hal_irq_enable(void)
+{
+   hostIrqEnabled = true;
+   host_service_irq();
+}
+
+uint8_t hal_irq_save(void)
+{
+   uint8_t state = hostIrqEnabled ? 1 : 0;
+   hostIrqEnabled = false;
+   return state;
+}
+
+void hal_irq_restore(uint8_t state)
+{
+   if(state)
+   {
+      hal_irq_enable();
+   }
+}
+
+void hal_can_irq_init(void)
+{
+   // level triggered only
+}
+
+void hal_can_irq_enable(void)
+{
+   hostInt0Enabled = true;
+}
+
+void hal_can_irq_disable(void)
+{
+   hostInt0Enabled = false;
+}
+
+void hal_sleep(uint8_t mode)
+{
+   uint64_t start = hostCycles;
+   uint64_t woken = hostCycles;
+   uint64_t next;
+
+   hostIrqEnabled = true;
+   // the ISR waking up runs after sleeping
+   while(!host_service_irq())
+   {
+      if(SLEEP_MODE_PWR_DOWN == mode)
+      {
+         // all clocks are stopped, only the bus may wake up
+         next = host_can_next_event();
+      }
+      else
+      {
+         next = host_next_event();
+      }
+
+      if(next >= hostEndCycles)
+      {
+         hostCycles = hostEndCycles;
+         woken      = hostCycles;
+         break;
+      }
+      hostCycles = next;
+      woken      = next;
+      host_update();
+   }
+   hostSleepCycles += woken - start;
+   if(SLEEP_MODE_IDLE == mode)
+   {
+      hostIdleCycles += woken - start;
+      hostResidency[hostState].idle += woken - start;
+   }
+   else
+   {
+      hostResidency[hostState].powerDown += woken - start;
+      if(woken < hostEndCycles)
+      {
+         hostWakeAt      = woken;
+         hostWakePending = true;
+      }
+   }
+}
+
+void hal_can_select(eChipSelect chip)
+{
+   host_can_chip_select(chip, true);
+}
+
+void hal_can_deselect(eChipSelect chip)
+{
+   host_can_chip_select(chip, false);
+}
+
+void hal_cycles_init(void)
+{
+}
+
+uint16_t hal_cycles(void)
+{
+   // deterministic, but only SPI, EEPROM and UART take virtual time
+   return (uint16_t)hostCycles;
+}
+
+void hal_debug_init(void)
+{
+#ifndef TELEMETRY
+   // the telemetry sets the UART up by hal_uart_init()
+   hostUartByteCycles = (F_CPU * 10UL) / HAL_DEBUG_BAUD;
+#endif
+}
+
+void hal_debug_putc(char c)
+{
+   host_uart_shift();
+   putchar(c);
+}
+
+bool hal_debug_requested(void)
+{
+   // the request pin is held low from then on
+   return (hostCycles >= hostDebugRequestAt);
+}
+
+void hal_uart_init(uint32_t baud)
+{
+   hostUartByteCycles = (F_CPU * 10UL) / baud;
+}
+
+void hal_uart_put(uint8_t byte)
+{
+   host_uart_shift();
+   ++hostUartBytes;
+   if(NULL != hostUartFile)
+   {
+      fputc(byte, hostUartFile);
+   }
+}
+
+void hal_uart_irq_enable(void)
+{
+   hostUartIrqEnabled = true;
+}
+
+void hal_uart_irq_disable(void)
+{
+   hostUartIrqEnabled = false;
+}
+
+bool hal_uart_sent(void)
+{
+   host_advance(HOST_UART_POLL_CYCLES);
+   return (hostCycles >= hostUartSentAt);
+}
+
+void hal_delay_ms(uint16_t ms)
+{
+   host_advance((uint64_t)ms * HOST_CYCLES_PER_MS);
+}
+
+uint8_t hal_eeprom_read(uint16_t addr)
+{
+   if(!hostEepromProgram)
+   {
+      ++hostEepromReads;
+      host_advance(HOST_EEPROM_READ_CYCLES);
+   }
+   return host_eeprom()[addr & E2END];
+}
+
+void hal_eeprom_write(uint16_t addr, uint8_t value)
+{
+   uint8_t* eeprom = host_eeprom();
+
+   if(eeprom[addr & E2END] != value)
+   {
+      eeprom[addr & E2END] = value;
+      if(!hostEepromProgram)
+      {
+         ++hostEepromWrites;
+         host_advance(HOST_EEPROM_WRITE_CYCLES);
+      }
+   }
+}
+
+uint8_t hal_timer2_compare(void)
+{
+   return host_timer2_ocr();
+}
+
+void hal_timer2_set_compare(uint8_t value)
+{
+   host_timer2_write_ocr(value);
+}
+
+uint16_t hal_timer1_count(void)
+{
+   return host_timer1_tcnt();
+}
+
+void hal_timer1_set_compare(uint16_t value)
+{
+   host_timer1_write_icr(value);
+}
+
+void hal_trace_init(void)
+{
+   // nothing to do on the host
+}
+
+void hal_trace_rx(const void* msg)
+{
+   uint8_t i;
+   uint8_t slot = 0;
+
+   ++hostRxFrames;
+
+   // a FIFO slot is reused for the next frame, even if not decoded
+   for(i = 0; i < HOST_TRACE_SLOTS; ++i)
+   {
+      if(msg == hostTrace[i].msg)
+      {
+         slot = i;
+         break;
+      }
+      if(NULL == hostTrace[i].msg)
+      {
+         slot = i;
+      }
+   }
+   hostTrace[slot].msg = msg;
+   hostTrace[slot].at  = host_can_rx_time();
+}
+
+void hal_trace_decoded(const void* msg)
+{
+   uint8_t i;
+   uint8_t col;
+
+   for(i = 0; i < HOST_TRACE_SLOTS; ++i)
+   {
+      if(msg == hostTrace[i].msg)
+      {
+         host_stats_add(&hostDecodeLatency, hostCycles - hostTrace[i].at);
+         if(hostWakePending)
+         {
+            host_stats_add(&hostWakeLatency, hostCycles - hostWakeAt);
+            hostWakePending = false;
+         }
+         for(col = 0; col < HOST_TRACE_COLUMNS; ++col)
+         {
+            if(!hostShownValid[col])
+            {
+               hostShownPending[col] = hostTrace[i].at;
+               hostShownValid[col]   = true;
+            }
+         }
+         hostTrace[i].msg = NULL;
+         break;
+      }
+   }
+}
+
+void hal_trace_filtered(uint8_t slot, uint8_t raw, uint8_t value)
+{
+   if(slot >= HOST_TRACE_SENSORS)
+   {
+      return;
+   }
+   if(hostLastValid[slot] &&
+      (PDC_OUT_OF_RANGE != raw) && (PDC_OUT_OF_RANGE != hostLastRaw[slot]) &&
+      (PDC_OUT_OF_RANGE != value) && (PDC_OUT_OF_RANGE != hostLastShown[slot]))
+   {
+      ++hostJitter.count;
+      hostJitter.raw   += (uint64_t)abs((int)raw - (int)hostLastRaw[slot]);
+      hostJitter.shown += (uint64_t)abs((int)value - (int)hostLastShown[slot]);
+   }
+   hostLastRaw[slot]   = raw;
+   hostLastShown[slot] = value;
+   hostLastValid[slot] = true;
+}
+
+void hal_trace_state(uint8_t state)
+{
+   host_account_state();
+   if(state < HOST_TRACE_STATES)
+   {
+      hostState = state;
+   }
+   if(NULL != hostStateHook)
+   {
+      hostStateHook(state);
+   }
+}
+
+void hal_trace_shown(uint8_t col)
+{
+   if((col < HOST_TRACE_COLUMNS) && hostShownValid[col])
+   {
+      host_stats_add(&hostDisplayLatency, hostCycles - hostShownPending[col]);
+      hostShownValid[col] = false;
+   }
+}
@@ -0,0 +1,481 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file hal_host.h
+ *
+ * Host implementation of the hardware abstraction. Do not include directly,
+ * use hal.h instead.
+ *
+ * The host runs on a virtual time base counting CPU cycles at F_CPU. Each
+ * pass of the main loop, each busy wait and each byte transferred via SPI
+ * advances the time, sleeping skips to the next event of the simulated
+ * peripherals. Interrupt service routines are plain functions called by
+ * the simulation. The simulation is deterministic, a run gives the same
+ * results on any host.
+ *
+ * \date Created: 16.10.2026 22:46:35
+ * \author agent
+ **/
+
+
+#ifndef HAL_HOST_H_
+#define HAL_HOST_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "host_io.h"
+#include "host_stats.h"
+#include "config/can_config_mcp2515.h"
+#include "config/spi_config.h"
+
+// === AVR COMPATIBILITY =====================================================
+
+//! sleep mode idle (all clocks running)
+#define SLEEP_MODE_IDLE          0
+//! sleep mode power down (only external interrupts wake up)
+#define SLEEP_MODE_PWR_DOWN      2
+
+//! constants stay in RAM
+#define PROGMEM
+//! read byte from flash
+#define pgm_read_byte(addr)      (*(const uint8_t*)(addr))
+//! read word from flash
+#define pgm_read_word(addr)      (*(const uint16_t*)(addr))
+//! copy from flash
+#define memcpy_P(dst, src, n)    memcpy((dst), (src), (n))
+//! string in flash
+#define PSTR(s)                  (s)
+
+//! last address of the EEPROM (ATmega8)
+#define E2END                    0x1FF
+
+/**
+ * \brief interrupt service routines are plain functions on the host
+ */
+#define ISR(vector)              void vector(void)
+
+//! Timer1 input capture
+#define TIMER1_CAPT_vect         host_isr_timer1_capt
+//! Timer2 output compare
+#define TIMER2_COMP_vect         host_isr_timer2_comp
+//! external interrupt 0
+#define INT0_vect                host_isr_int0
+//! UART data register empty
+#define USART_UDRE_vect          host_isr_usart_udre
+
+ISR(TIMER1_CAPT_vect);
+ISR(TIMER2_COMP_vect);
+ISR(INT0_vect);
+ISR(USART_UDRE_vect);
+
+// === HAL ===================================================================
+
+bool hal_running(void);
+
+void hal_irq_disable(void);
+void hal_irq_enable(void);
+uint8_t hal_irq_save(void);
+void hal_irq_restore(uint8_t state);
+
+void hal_can_irq_init(void);
+void hal_can_irq_enable(void);
+void hal_can_irq_disable(void);
+
+void hal_sleep(uint8_t mode);
+
+void hal_can_select(eChipSelect chip);
+void hal_can_deselect(eChipSelect chip);
+
+void hal_cycles_init(void);
+uint16_t hal_cycles(void);
+
+void hal_debug_init(void);
+void hal_debug_putc(char c);
+bool hal_debug_requested(void);
+
+void hal_uart_init(uint32_t baud);
+void hal_uart_put(uint8_t byte);
+void hal_uart_irq_enable(void);
+void hal_uart_irq_disable(void);
+bool hal_uart_sent(void);
+
+void hal_delay_ms(uint16_t ms);
+
+uint8_t hal_eeprom_read(uint16_t addr);
+void hal_eeprom_write(uint16_t addr, uint8_t value);
+
+/**
+ * \brief update CRC-CCITT by a byte
+ *
+ * C equivalent of _crc_ccitt_update() given by avr-libc. Inline, so tools
+ * of the host not linking the simulation can use it.
+ *
+ * \param crc so far
+ * \param data byte
+ * \return updated CRC
+ */
+static inline uint16_t hal_crc_ccitt_update(uint16_t crc, uint8_t data)
+{
+   data ^= (uint8_t)crc;
+   data ^= (uint8_t)(data << 4);
+
+   return (uint16_t)((((uint16_t)data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4) ^ ((uint16_t)data << 3));
+}
+
+uint8_t hal_timer2_compare(void);
+void hal_timer2_set_compare(uint8_t value);
+
+uint16_t hal_timer1_count(void);
+void hal_timer1_set_compare(uint16_t value);
+
+void hal_trace_init(void);
+void hal_trace_rx(const void* msg);
+void hal_trace_decoded(const void* msg);
+void hal_trace_filtered(uint8_t slot, uint8_t raw, uint8_t value);
+void hal_trace_shown(uint8_t col);
+void hal_trace_state(uint8_t state);
+
+// === SIMULATION ============================================================
+
+/**
+ * \brief virtual cycles per millisecond
+ */
+#define HOST_CYCLES_PER_MS       (F_CPU / 1000UL)
+
+/**
+ * \brief default virtual cycles used by one pass of the main loop
+ */
+#define HOST_LOOP_CYCLES         100
+
+/**
+ * \brief value for "no event pending"
+ */
+#define HOST_NO_EVENT            UINT64_MAX
+
+/**
+ * \brief current virtual time in CPU cycles
+ */
+extern uint64_t hostCycles;
+
+/**
+ * \brief set end of simulation
+ * \param cycles virtual time to end the simulation
+ */
+void host_set_end(uint64_t cycles);
+
+/**
+ * \brief advance virtual time and run all peripherals and interrupts
+ * \param cycles to advance
+ */
+void host_advance(uint64_t cycles);
+
+/**
+ * \brief get number of main loop passes
+ * \return passes since start of simulation
+ */
+uint64_t host_loop_passes(void);
+
+/**
+ * \brief get cycles spent sleeping
+ * \return virtual cycles in any sleep mode
+ */
+uint64_t host_sleep_cycles(void);
+
+/**
+ * \brief get cycles spent in idle mode
+ *
+ * Included in host_sleep_cycles(). The rest was spent in power down mode.
+ *
+ * \return virtual cycles in idle mode
+ */
+uint64_t host_idle_cycles(void);
+
+/**
+ * \brief estimated CPU cycles of one byte transferred via SPI
+ *
+ * spi_putc() polls SPIF for 8 SPI clocks, plus writing and reading SPDR.
+ */
+#define HOST_SPI_CYCLES_PER_BYTE (8UL * SPI_PRESCALER + 8UL)
+
+/**
+ * \brief interrupts of the simulation
+ */
+typedef enum
+{
+   HOST_IRQ_INT0     = 0,
+   HOST_IRQ_TIMER2   = 1,
+   HOST_IRQ_TIMER1   = 2,
+   HOST_IRQ_UART     = 3,
+   HOST_NUM_OF_IRQS  = 4
+} host_irq_t;
+
+/**
+ * \brief get number of calls of an interrupt service routine
+ * \param irq interrupt
+ * \return calls since start of simulation
+ */
+uint64_t host_isr_calls(host_irq_t irq);
+
+/**
+ * \brief get bytes transferred via SPI by an interrupt service routine
+ * \param irq interrupt
+ * \return bytes since start of simulation
+ */
+uint64_t host_isr_spi_bytes(host_irq_t irq);
+
+/**
+ * \brief get number of frames read from the CAN controllers
+ * \return frames (see hal_trace_rx())
+ */
+uint64_t host_rx_frames(void);
+
+//! maximum number of states of the FSM traced
+#define HOST_TRACE_STATES        8
+
+/**
+ * \brief time spent in a state of the FSM
+ */
+typedef struct
+{
+   //! virtual cycles in the state
+   uint64_t total;
+   //! thereof in idle mode
+   uint64_t idle;
+   //! thereof in power down mode
+   uint64_t powerDown;
+   //! bytes transferred via SPI in the state
+   uint32_t spiBytes;
+} host_residency_t;
+
+/**
+ * \brief called on entering a state of the FSM
+ * \param state entered (see hal_trace_state())
+ */
+typedef void (*host_state_hook_t)(uint8_t state);
+
+/**
+ * \brief set function called on entering a state of the FSM
+ *
+ * E.g. to put a frame on the bus at a given time after a transition.
+ *
+ * \param hook to call or NULL
+ */
+void host_set_state_hook(host_state_hook_t hook);
+
+/**
+ * \brief get time spent in a state of the FSM up to now
+ * \param state of the FSM (see hal_trace_state())
+ * \return residency
+ */
+const host_residency_t* host_state_residency(uint8_t state);
+
+/**
+ * \brief get latencies from reception of a frame by the controller until
+ *        its PDC values are decoded
+ * \return set of samples in virtual cycles
+ */
+host_stats_t* host_decode_latency(void);
+
+/**
+ * \brief get latencies from reception of a frame by the controller until
+ *        its PDC values are set in the matrixbar
+ *
+ * A column refreshed after decoding shows the values of the frame. Frames
+ * decoded again before are measured by the oldest one.
+ *
+ * \return set of samples in virtual cycles
+ */
+host_stats_t* host_display_latency(void);
+
+/**
+ * \brief get latencies from waking up from power down until the first
+ *        frame is decoded
+ * \return set of samples in virtual cycles
+ */
+host_stats_t* host_wake_latency(void);
+
+/**
+ * \brief changes of the sensor values from frame to frame
+ *
+ * Changes from or to PDC_OUT_OF_RANGE are not counted.
+ */
+typedef struct
+{
+   //! changes compared
+   uint64_t count;
+   //! sum of the absolute changes of the values decoded
+   uint64_t raw;
+   //! sum of the absolute changes of the values filtered
+   uint64_t shown;
+} host_jitter_t;
+
+/**
+ * \brief get changes of the sensor values (see hal_trace_filtered())
+ * \return changes since start of simulation
+ */
+const host_jitter_t* host_jitter(void);
+
+/**
+ * \brief virtual cycles of writing a byte of the EEPROM (8.5ms)
+ */
+#define HOST_EEPROM_WRITE_CYCLES (HOST_CYCLES_PER_MS * 17 / 2)
+
+/**
+ * \brief estimated cycles of eeprom_read_byte() (call, EEAR, 4 cycles halted)
+ */
+#define HOST_EEPROM_READ_CYCLES  16
+
+/**
+ * \brief load the EEPROM from an image file
+ *
+ * The EEPROM is erased (0xFF) before. A missing file is not an error, so
+ * the first run starts with an erased EEPROM.
+ *
+ * \param path of image file
+ * \return false, if the file can't be read
+ */
+bool host_eeprom_load(const char* path);
+
+/**
+ * \brief save the EEPROM to an image file
+ * \param path of image file
+ * \return false, if the file can't be written
+ */
+bool host_eeprom_save(const char* path);
+
+/**
+ * \brief access the EEPROM like a programmer
+ *
+ * Meanwhile no virtual time passes and the accesses are not counted, e.g.
+ * to program settings before the simulation starts.
+ *
+ * \param enable programmer
+ */
+void host_eeprom_program(bool enable);
+
+/**
+ * \brief get number of bytes written to the EEPROM
+ * \return bytes changed by hal_eeprom_write() since start of simulation
+ */
+uint32_t host_eeprom_writes(void);
+
+/**
+ * \brief get number of bytes read from the EEPROM
+ * \return bytes read by hal_eeprom_read() since start of simulation
+ */
+uint32_t host_eeprom_reads(void);
+
+/**
+ * \brief estimated CPU cycles of ISR(USART_UDRE_vect) sending a byte
+ *
+ * Interrupt response, saving and restoring the registers used (~40) and
+ * the ring access (~20). Measured on the AVR by the probe PROF_ISR_UART.
+ */
+#define HOST_UART_ISR_CYCLES     60
+
+/**
+ * \brief estimated CPU cycles of encoding a byte of a record (COBS)
+ *
+ * Measured on the AVR by the probe PROF_TELEMETRY per record.
+ */
+#define HOST_UART_ENCODE_CYCLES  15
+
+/**
+ * \brief estimated cycles of polling a flag of the UART
+ */
+#define HOST_UART_POLL_CYCLES    4
+
+/**
+ * \brief write all bytes sent via UART to a file
+ * \param path of the file
+ * \return false, if the file can't be created
+ */
+bool host_uart_open(const char* path);
+
+/**
+ * \brief close the file of host_uart_open(), if any
+ */
+void host_uart_close(void);
+
+/**
+ * \brief send without delay from now on
+ *
+ * The simulation ends before the ring of the telemetry is sent, so the
+ * rest and the dumps following are sent without virtual time passing.
+ */
+void host_uart_instant(void);
+
+/**
+ * \brief get bytes sent via UART
+ * \return bytes since start of simulation
+ */
+uint64_t host_uart_bytes(void);
+
+/**
+ * \brief get virtual cycles the UART needs per byte
+ * \return cycles set by hal_uart_init() or 0
+ */
+uint64_t host_uart_byte_cycles(void);
+
+/**
+ * \brief pull the request pin of the debug channel low (see
+ *        hal_debug_requested())
+ * \param cycles virtual time to request the dumps at
+ */
+void host_debug_request(uint64_t cycles);
+
+// --- peripherals -----------------------------------------------------------
+
+/**
+ * \brief get next event of the timers
+ * \return virtual time of next compare match or HOST_NO_EVENT
+ */
+uint64_t host_timer_next_event(void);
+
+/**
+ * \brief update timers to current virtual time
+ */
+void host_timer_update(void);
+
+/**
+ * \brief check and clear pending Timer1 capture interrupt
+ * \return true, if pending
+ */
+bool host_timer1_irq_take(void);
+
+/**
+ * \brief check and clear pending Timer2 compare interrupt
+ * \return true, if pending
+ */
+bool host_timer2_irq_take(void);
+
+/**
+ * \brief get next event on the simulated CAN bus(ses)
+ * \return virtual time of next frame or HOST_NO_EVENT
+ */
+uint64_t host_can_next_event(void);
+
+/**
+ * \brief deliver all frames up to current virtual time to the controllers
+ */
+void host_can_update(void);
+
+/**
+ * \brief state of INT0, the interrupt lines of all CAN controllers
+ * \return true, if line is active (low)
+ */
+bool host_can_int_active(void);
+
+#endif /* HAL_HOST_H_ */
@@ -0,0 +1,62 @@
+##################################################################################
+#
+# "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+# <dev@layer128.net> wrote this file. As long as you retain this notice you
+# can do whatever you want with this stuff. If we meet some day, and you think
+# this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+# like beer much.)
+#
+# Matthias Kleemann
+#
+##################################################################################
+#
+# Runs a scenario of the host simulation and compares a value of its report
+# against a limit, so a regression fails the test.
+#
+# cmake -DEXE=<PDCViewerHost> -DARGS=<a|b|c> -DREGEX=<regex capturing the value>
+#       [-DMAX=<limit>] [-DMIN=<limit>] [-DBASELINE=<a|b|c>] -P host_check.cmake
+#
+# The value must not exceed MAX nor fall below MIN. If BASELINE is given, it
+# must not exceed the value of the run with these options either, e.g. to
+# compare two policies.
+#
+##################################################################################
+
+#
+# run the simulation and take the value from its report
+#
+function(host_check_run args value)
+   string(REPLACE "|" ";" argList "${args}")
+   execute_process(
+      COMMAND ${EXE} ${argList}
+      OUTPUT_VARIABLE report
+      ERROR_QUIET
+      RESULT_VARIABLE result
+   )
+   if(NOT "${result}" STREQUAL "0")
+      message(FATAL_ERROR "${EXE} ${argList} failed (${result}):\n${report}")
+   endif()
+   if(NOT "${report}" MATCHES "${REGEX}")
+      message(FATAL_ERROR "'${REGEX}' not found in the report:\n${report}")
+   endif()
+   set(${value} "${CMAKE_MATCH_1}" PARENT_SCOPE)
+endfunction(host_check_run)
+
+host_check_run("${ARGS}" value)
+message(STATUS "${ARGS}: ${value}")
+
+if(DEFINED MAX AND value GREATER MAX)
+   message(FATAL_ERROR "${value} exceeds the limit of ${MAX}")
+endif()
+
+if(DEFINED MIN AND value LESS MIN)
+   message(FATAL_ERROR "${value} is below the limit of ${MIN}")
+endif()
+
+if(DEFINED BASELINE)
+   host_check_run("${BASELINE}" baseline)
+   message(STATUS "${BASELINE}: ${baseline}")
+   if(value GREATER baseline)
+      message(FATAL_ERROR "${value} exceeds ${baseline} of the baseline")
+   endif()
+endif()
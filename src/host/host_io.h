@@ -0,0 +1,53 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file host_io.h
+ *
+ * Registers and bit names of the ATmega8 needed by the configuration files.
+ * The registers are plain variables on the host.
+ *
+ * \date Created: 16.10.2026 22:46:35
+ * \author agent
+ **/
+
+
+#ifndef HOST_IO_H_
+#define HOST_IO_H_
+
+#include <stdint.h>
+
+#ifndef F_CPU
+   #define F_CPU 4000000UL
+#endif
+
+extern volatile uint8_t DDRB;
+extern volatile uint8_t PORTB;
+extern volatile uint8_t DDRC;
+extern volatile uint8_t PORTC;
+extern volatile uint8_t DDRD;
+extern volatile uint8_t PORTD;
+
+// Timer0 clock select
+#define CS00   0
+#define CS01   1
+#define CS02   2
+// Timer1 clock select
+#define CS10   0
+#define CS11   1
+#define CS12   2
+// Timer2 clock select
+#define CS20   0
+#define CS21   1
+#define CS22   2
+
+#endif /* HOST_IO_H_ */
@@ -0,0 +1,647 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file host_main.c
+ *
+ * Entry point of the host-native build. Sets up the simulation, runs the
+ * FSM of PDCViewer and reports the results.
+ *
+ * \date Created: 16.10.2026 22:46:35
+ * \author agent
+ **/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hal.h"
+#include "can/can_mcp2515.h"
+#include "can_autobaud.h"
+#include "can_fifo.h"
+#include "can_rx.h"
+#include "config_store.h"
+#include "debug.h"
+#include "display.h"
+#include "mcp2515_burst.h"
+#include "mcp2515_shadow.h"
+#include "pdc_filter.h"
+#include "power.h"
+#include "profiler.h"
+#include "sleep_policy.h"
+#include "systick.h"
+#include "telemetry.h"
+#include "PDCViewer.h"
+#include "bus_stats.h"
+#include "bench.h"
+#include "bitrate.h"
+#include "energy.h"
+#include "filter_name.h"
+#include "replay.h"
+#include "timer/timer.h"
+
+// === DEFINITIONS ===========================================================
+
+//! default simulation time in ms
+#define HOST_DEFAULT_TIME_MS  60000
+
+//! simulation time after the end of a replay in ms (bus sleep is reached)
+#define HOST_REPLAY_TAIL_MS   20000
+
+//! virtual time of the first replayed frame in ms
+#define HOST_REPLAY_START_MS  100
+
+//! distance sent by the frames injected into the race (raw value)
+#define HOST_RACE_DISTANCE    50
+
+/**
+ * \brief simulated bus of a controller
+ */
+typedef struct
+{
+   //! benchmark: period of the PDC frames in ms or 0
+   unsigned long periodMs;
+   //! benchmark: load by other frames in percent
+   unsigned long load;
+   //! benchmark: outliers in percent
+   unsigned long noise;
+   //! benchmark: time driving each cycle in ms or 0
+   unsigned long driveMs;
+   //! benchmark: time parked each cycle in ms
+   unsigned long parkMs;
+   //! bitrate in kbps
+   unsigned long kbps;
+   //! bitrate
+   eCanBitRate   bitrate;
+   //! benchmark
+   bench_t       bench;
+} host_bus_t;
+
+//! main() of PDCViewer.c
+int pdcviewer_main(void);
+
+extern state_t fsmState;
+extern uint8_t pdcValueStored[NUM_OF_PDC_SENSORS];
+extern uint16_t pdcStaleCount;
+
+//! race: a frame is injected each time sleep is detected
+static bool raceSet           = false;
+
+//! race: virtual cycles after sleep is detected
+static uint64_t raceCycles    = 0;
+
+//! race: bus of the frames injected
+static eChipSelect raceChip   = CAN_CHIP1;
+
+//! race: frames injected
+static unsigned long raceFrames = 0;
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief print usage
+ * \param name of program
+ */
+static void usage(const char* name)
+{
+   fprintf(stderr,
+           "usage: %s [-t ms] [[-c bus] [-f id#data@ms]... [-r trace [-s speed] | -p ms [-l load]\n"
+           "          [-n noise] [-o drive,park]] [-k us] [-z] [-a] [-b kbps]]... [-m compare]\n"
+           "          [-d level] [-g filter] [-x us] [-F] [-e image] [-u file] [-q ms]\n"
+           "  -t ms           simulated time (default %d ms, or end of replay + %d ms)\n"
+           "  -c bus          following -f, -r, -p, -l, -n, -o, -k, -z, -a and -b apply to the\n"
+           "                  bus of controller 1..%d (default 1)\n"
+           "  -f id#data@ms   put frame on the bus at given time, e.g. 54B#FFFF3040FFFF5060@100\n"
+           "  -r trace        replay candump or Vector ASC trace\n"
+           "  -s speed        factor of the original timing (default 1),\n"
+           "                  0 replays as fast as the bus allows\n"
+           "  -p ms           benchmark: send PDC frames with changing distances each ms\n"
+           "  -l load         benchmark: load bus with other frames (percent)\n"
+           "  -n noise        benchmark: replace distances by outliers (percent)\n"
+           "  -o drive,park   benchmark: drive and park in turns (ms each), the bus is silent\n"
+           "                  while parked\n"
+           "  -k us           race: put a PDC frame on the bus each time sleep is detected,\n"
+           "                  the given time later\n"
+           "  -m compare      compare value of Timer2 (display multiplexing, default %d)\n"
+           "  -d level        brightness of the display 0..%d\n"
+           "  -g filter       stages of the filter: none or median, ema, rate joined by '+'\n"
+           "  -x us           fail, if p99 of display latency exceeds the threshold\n"
+           "  -F              fixed bus sleep timeout instead of the adaptive one, values\n"
+           "                  are shown until sleeping\n"
+           "  -z              MCP2515 loses its configuration on each wake up\n"
+           "  -a              MCP2515 is absent, initialization fails\n"
+           "  -b kbps         bitrate of the bus: 20, 33, 50, 83, 100 (default), 125 or 250\n"
+           "  -e image        load EEPROM from image file (if any) and save it at the end\n"
+           "  -u file         write bytes sent via UART (telemetry) to file\n"
+           "  -q ms           request the dumps of the debug channel at given time, they are\n"
+           "                  printed at the end anyway\n"
+           "-m, -d, -g and -F program the settings into the EEPROM before the simulation starts\n",
+           name, HOST_DEFAULT_TIME_MS, HOST_REPLAY_TAIL_MS, NUM_OF_MCP2515, TIMER2_COMPARE_VALUE,
+           DISPLAY_BRIGHTNESS_MAX);
+}
+
+/**
+ * \brief get wall clock time of the host
+ * \return time in s
+ */
+static double wall_time(void)
+{
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/**
+ * \brief put a PDC frame on the bus at the time given after sleep is
+ *        detected (host_state_hook_t)
+ * \param state entered
+ */
+static void host_race(uint8_t state)
+{
+   can_t msg;
+
+   if(SLEEP_DETECTED != state)
+   {
+      return;
+   }
+   memset(&msg, 0, sizeof(msg));
+   msg.msgId      = PDC_CAN_ID;
+   msg.header.len = 8;
+   memset(msg.data, HOST_RACE_DISTANCE, sizeof(msg.data));
+   if(host_can_inject(raceChip, hostCycles + raceCycles, &msg))
+   {
+      ++raceFrames;
+   }
+}
+
+// === MAIN ==================================================================
+
+int main(int argc, char** argv)
+{
+   unsigned long timeMs = HOST_DEFAULT_TIME_MS;
+   bool          timeSet = false;
+   const char*   trace   = NULL;
+   double        speed   = 1.0;
+   unsigned long threshold = 0;
+   host_bus_t    buses[NUM_OF_MCP2515];
+   host_bus_t*   bus       = &buses[CAN_CHIP1];
+   eChipSelect   chip      = CAN_CHIP1;
+   eChipSelect   traceChip = CAN_CHIP1;
+   const char*   eeprom    = NULL;
+   const char*   uart      = NULL;
+   long          compare   = -1;
+   long          level     = -1;
+   const char*   filter    = NULL;
+   uint8_t       stages    = PDC_FILTER_DEFAULT;
+   bool          fixed     = false;
+   config_t      settings;
+   double        wall;
+   uint64_t      awake;
+   uint64_t      powerDown;
+   const char*   rest;
+   replay_t      replay;
+   can_t         msg;
+   uint32_t      lost;
+   int           opt;
+
+   for(opt = 0; opt < NUM_OF_MCP2515; ++opt)
+   {
+      buses[opt].periodMs = 0;
+      buses[opt].load     = 0;
+      buses[opt].noise    = 0;
+      buses[opt].driveMs  = 0;
+      buses[opt].parkMs   = 0;
+      buses[opt].kbps     = 100;
+   }
+
+   while(-1 != (opt = getopt(argc, argv, "t:c:f:r:s:p:l:n:o:k:m:d:g:x:Fzab:e:u:q:h")))
+   {
+      switch(opt)
+      {
+         case 'c':
+         {
+            opt = (int)strtoul(optarg, NULL, 0);
+            if((opt < 1) || (opt > NUM_OF_MCP2515))
+            {
+               usage(argv[0]);
+               return EXIT_FAILURE;
+            }
+            chip = (eChipSelect)(opt - 1);
+            bus  = &buses[chip];
+            break;
+         }
+
+         case 't':
+         {
+            timeMs  = strtoul(optarg, NULL, 0);
+            timeSet = true;
+            break;
+         }
+
+         case 'r':
+         {
+            trace     = optarg;
+            traceChip = chip;
+            break;
+         }
+
+         case 's':
+         {
+            speed = strtod(optarg, NULL);
+            if(speed < REPLAY_SPEED_BUS)
+            {
+               usage(argv[0]);
+               return EXIT_FAILURE;
+            }
+            break;
+         }
+
+         case 'p':
+         {
+            bus->periodMs = strtoul(optarg, NULL, 0);
+            break;
+         }
+
+         case 'l':
+         {
+            bus->load = strtoul(optarg, NULL, 0);
+            break;
+         }
+
+         case 'n':
+         {
+            bus->noise = strtoul(optarg, NULL, 0);
+            break;
+         }
+
+         case 'o':
+         {
+            bus->driveMs = strtoul(optarg, (char**)&rest, 0);
+            if((',' != *rest) || (0 == bus->driveMs))
+            {
+               usage(argv[0]);
+               return EXIT_FAILURE;
+            }
+            bus->parkMs = strtoul(rest + 1, NULL, 0);
+            break;
+         }
+
+         case 'k':
+         {
+            raceCycles = strtoull(optarg, NULL, 0) * (F_CPU / 1000000UL);
+            raceChip   = chip;
+            raceSet    = true;
+            break;
+         }
+
+         case 'm':
+         {
+            compare = (long)strtoul(optarg, NULL, 0);
+            break;
+         }
+
+         case 'd':
+         {
+            level = (long)strtoul(optarg, NULL, 0);
+            break;
+         }
+
+         case 'g':
+         {
+            filter = optarg;
+            break;
+         }
+
+         case 'x':
+         {
+            threshold = strtoul(optarg, NULL, 0);
+            break;
+         }
+
+         case 'F':
+         {
+            fixed = true;
+            break;
+         }
+
+         case 'z':
+         {
+            host_can_reset_on_wake(chip, true);
+            break;
+         }
+
+         case 'a':
+         {
+            host_can_set_missing(chip, true);
+            break;
+         }
+
+         case 'b':
+         {
+            bus->kbps = strtoul(optarg, NULL, 0);
+            break;
+         }
+
+         case 'e':
+         {
+            eeprom = optarg;
+            break;
+         }
+
+         case 'u':
+         {
+            uart = optarg;
+            break;
+         }
+
+         case 'q':
+         {
+            host_debug_request(strtoull(optarg, NULL, 0) * HOST_CYCLES_PER_MS);
+            break;
+         }
+
+         case 'f':
+         {
+            rest = replay_parse_frame(optarg, &msg);
+            if((NULL == rest) || ('@' != *rest) ||
+               !host_can_push(chip, strtoull(rest + 1, NULL, 0) * HOST_CYCLES_PER_MS, &msg))
+            {
+               fprintf(stderr, "invalid frame: %s\n", optarg);
+               return EXIT_FAILURE;
+            }
+            break;
+         }
+
+         default:
+         {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+         }
+      }
+   }
+
+   if(((NULL != trace) && (0 != buses[traceChip].periodMs)) || (compare > UINT8_MAX) ||
+      (level > UINT8_MAX) || ((NULL != filter) && !host_filter_parse(filter, &stages)))
+   {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+   }
+   for(bus = buses; bus < &buses[NUM_OF_MCP2515]; ++bus)
+   {
+      if((bus->load > 100) || (bus->noise > 100) || (bus->periodMs > UINT16_MAX) ||
+         !host_bitrate_find(bus->kbps, &bus->bitrate))
+      {
+         usage(argv[0]);
+         return EXIT_FAILURE;
+      }
+   }
+
+   if((NULL != eeprom) && !host_eeprom_load(eeprom))
+   {
+      perror(eeprom);
+      return EXIT_FAILURE;
+   }
+   if((NULL != uart) && !host_uart_open(uart))
+   {
+      perror(uart);
+      return EXIT_FAILURE;
+   }
+
+   // settings given are programmed into the EEPROM before power on
+   if((compare >= 0) || (level >= 0) || (NULL != filter) || fixed)
+   {
+      host_eeprom_program(true);
+      config_load();
+      settings = *config_get();
+      if(compare >= 0)
+      {
+         settings.timer2Compare = (uint8_t)compare;
+      }
+      if(level >= 0)
+      {
+         settings.brightness = (uint8_t)level;
+      }
+      if(NULL != filter)
+      {
+         settings.filter = stages;
+      }
+      if(fixed)
+      {
+         // fixed bus silent timeout of ~15s, values are shown until sleeping
+         settings.pdcShift = 0;
+         settings.pdcMin   = SLEEP_POLICY_NEVER;
+         settings.pdcMax   = SLEEP_POLICY_NEVER;
+         settings.busShift = 0;
+         settings.busMin   = TIMER1_COMPARE_VALUE;
+         settings.busMax   = TIMER1_COMPARE_VALUE;
+         settings.staleAge = SYSTICK_NEVER;
+      }
+      config_set(&settings);
+      config_save();
+      host_eeprom_program(false);
+   }
+
+   host_set_end((uint64_t)timeMs * HOST_CYCLES_PER_MS);
+
+   for(chip = CAN_CHIP1; chip < NUM_OF_MCP2515; ++chip)
+   {
+      bus = &buses[chip];
+      host_can_set_bitrate(chip, bus->bitrate);
+      if(0 != bus->periodMs)
+      {
+         bench_init(&bus->bench, host_bitrate(bus->bitrate), (uint16_t)bus->periodMs,
+                    (uint8_t)bus->load, (uint8_t)bus->noise, HOST_REPLAY_START_MS * HOST_CYCLES_PER_MS);
+         bench_set_cycle(&bus->bench, (uint32_t)bus->driveMs, (uint32_t)bus->parkMs);
+         host_can_set_source(chip, bench_next, &bus->bench);
+      }
+   }
+
+   if(NULL != trace)
+   {
+      if(!replay_open(&replay, trace, speed, host_bitrate(buses[traceChip].bitrate),
+                      HOST_REPLAY_START_MS * HOST_CYCLES_PER_MS))
+      {
+         perror(trace);
+         return EXIT_FAILURE;
+      }
+      if(!timeSet)
+      {
+         // ends after the replay
+         replay.tail = HOST_REPLAY_TAIL_MS * HOST_CYCLES_PER_MS;
+         host_set_end(HOST_NO_EVENT);
+      }
+      host_can_set_source(traceChip, replay_next, &replay);
+   }
+
+   if(raceSet)
+   {
+      host_set_state_hook(host_race);
+   }
+
+   wall = wall_time();
+   pdcviewer_main();
+   wall = wall_time() - wall;
+
+   printf("simulated time:   %llu ms\n", (unsigned long long)(hostCycles / HOST_CYCLES_PER_MS));
+   printf("main loop passes: %llu\n",    (unsigned long long)host_loop_passes());
+   printf("sleeping:         %llu ms (idle), %llu ms (power down)\n",
+          (unsigned long long)(host_idle_cycles() / HOST_CYCLES_PER_MS),
+          (unsigned long long)((host_sleep_cycles() - host_idle_cycles()) / HOST_CYCLES_PER_MS));
+
+   // the CPU executes main loop passes and ISRs transferring via SPI
+   awake     = hostCycles - host_sleep_cycles();
+   powerDown = host_sleep_cycles() - host_idle_cycles();
+   if(hostCycles > powerDown)
+   {
+      printf("CPU duty:         %.2f %% while not powered down\n",
+             100.0 * (double)awake / (double)(hostCycles - powerDown));
+   }
+   printf("final state:      %d\n",      fsmState);
+   printf("PDC values:      ");
+   for(opt = 0; opt < NUM_OF_PDC_SENSORS; ++opt)
+   {
+      printf(" %u", pdcValueStored[opt]);
+   }
+   printf(" (%u stale values blanked)\n", pdcStaleCount);
+   printf("CAN init:         %llu ms, %lu EEPROM writes\n",
+          (unsigned long long)(host_state_residency(INIT)->total / HOST_CYCLES_PER_MS),
+          (unsigned long)host_eeprom_writes());
+   for(chip = CAN_CHIP1; chip < NUM_OF_MCP2515; ++chip)
+   {
+      // frames accepted by the filters, but lost in the MCP2515 or the FIFO
+      lost = host_can_lost(chip) + can_rx_dropped(chip);
+      printf("bus %d bitrate:    %lu kbit/s %s after %u probes (%s)\n", chip + 1,
+             host_bitrate_kbps(can_autobaud_result(chip)->bitrate),
+             can_autobaud_result(chip)->locked ? "locked" : "assumed",
+             can_autobaud_result(chip)->probes,
+             can_autobaud_result(chip)->cached ? "cached" : "not cached");
+      printf("bus %d frames:     %lu accepted, %lu lost (MCP2515), %u dropped (FIFO), %.2f %% drop rate\n",
+             chip + 1, (unsigned long)host_can_accepted(chip), (unsigned long)host_can_lost(chip),
+             can_rx_dropped(chip),
+             (0 != host_can_accepted(chip)) ? (100.0 * lost / host_can_accepted(chip)) : 0.0);
+      printf("bus %d overflows:  %u (RXB0), %u (RXB1), %u repaired on wake up\n", chip + 1,
+             mcp2515_rx_overflows(chip, 0), mcp2515_rx_overflows(chip, 1),
+             mcp2515_shadow_repairs(chip));
+      if(0 != buses[chip].driveMs)
+      {
+         printf("bus %d drives:     %lu ms driving, %lu ms parked in turns\n", chip + 1,
+                buses[chip].driveMs, buses[chip].parkMs);
+      }
+      if(0 != buses[chip].periodMs)
+      {
+         printf("bus %d benchmark:  %lu PDC frames, %lu other frames generated\n", chip + 1,
+                (unsigned long)buses[chip].bench.pdcFrames,
+                (unsigned long)buses[chip].bench.loadFrames);
+      }
+   }
+   if(CONFIG_NO_SLOT != config_slot())
+   {
+      printf("settings:         slot %u", config_slot());
+   }
+   else
+   {
+      printf("settings:         defaults");
+   }
+   printf(", %lu EEPROM bytes read (%lu cycles)\n", (unsigned long)host_eeprom_reads(),
+          (unsigned long)host_eeprom_reads() * HOST_EEPROM_READ_CYCLES);
+   printf("PDC filter:       %s, mean change per frame %.2f (decoded), %.2f (shown)\n",
+          host_filter_name(config_get()->filter),
+          (0 != host_jitter()->count) ? ((double)host_jitter()->raw / host_jitter()->count) : 0.0,
+          (0 != host_jitter()->count) ? ((double)host_jitter()->shown / host_jitter()->count) : 0.0);
+   printf("SPI bytes:        %lu, %lu (init), %lu (wake up)\n",
+          (unsigned long)host_can_spi_bytes(),
+          (unsigned long)host_state_residency(INIT)->spiBytes,
+          (unsigned long)host_state_residency(WAKEUP)->spiBytes);
+   printf("SPI cycles:       %lu (init), %.0f per frame (%.1f bytes, F_CPU/%d)\n",
+          (unsigned long)(host_state_residency(INIT)->spiBytes * HOST_SPI_CYCLES_PER_BYTE),
+          (0 != host_rx_frames()) ? ((double)host_isr_spi_bytes(HOST_IRQ_INT0) *
+                                     HOST_SPI_CYCLES_PER_BYTE / host_rx_frames()) : 0.0,
+          (0 != host_rx_frames()) ? ((double)host_isr_spi_bytes(HOST_IRQ_INT0) / host_rx_frames()) : 0.0,
+          SPI_PRESCALER);
+   printf("interrupts:       %llu (INT0), %llu (TIMER2), %llu (TIMER1), %llu (UART)\n",
+          (unsigned long long)host_isr_calls(HOST_IRQ_INT0),
+          (unsigned long long)host_isr_calls(HOST_IRQ_TIMER2),
+          (unsigned long long)host_isr_calls(HOST_IRQ_TIMER1),
+          (unsigned long long)host_isr_calls(HOST_IRQ_UART));
+   printf("frames dropped:   %u (FIFO, max. level %u/%u)\n",
+          can_fifo_dropped(), can_fifo_high_water(), CAN_FIFO_SIZE);
+
+#ifdef TELEMETRY
+   // throughput while not powered down, the UART stops meanwhile
+   if(hostCycles > powerDown)
+   {
+      printf("telemetry:        %u records, %u dropped, %llu bytes, %.0f bytes/s, UART %.1f %% busy\n",
+             telemetry_records(), telemetry_dropped(), (unsigned long long)host_uart_bytes(),
+             (double)host_uart_bytes() * F_CPU / (hostCycles - powerDown),
+             100.0 * host_uart_bytes() * host_uart_byte_cycles() / (hostCycles - powerDown));
+      printf("telemetry CPU:    %d cycles per byte (estimated), %.2f %% of the CPU, %.1f %% at the\n"
+             "                  UART limit of %lu bytes/s\n",
+             HOST_UART_ISR_CYCLES + HOST_UART_ENCODE_CYCLES,
+             100.0 * host_uart_bytes() * (HOST_UART_ISR_CYCLES + HOST_UART_ENCODE_CYCLES) /
+             (hostCycles - powerDown),
+             100.0 * (HOST_UART_ISR_CYCLES + HOST_UART_ENCODE_CYCLES) * (TELEMETRY_BAUD / 10) / F_CPU,
+             TELEMETRY_BAUD / 10);
+   }
+#endif
+
+   printf("wake ups:         %u (frames), %u (spurious)\n",
+          power_stats()->wakeups[POWER_WAKE_FRAME], power_stats()->wakeups[POWER_WAKE_SPURIOUS]);
+   if(raceSet)
+   {
+      printf("race:             %lu frames injected %llu us after sleep detected (bus %d)\n",
+             raceFrames, (unsigned long long)(raceCycles / (F_CPU / 1000000UL)), raceChip + 1);
+   }
+   energy_print();
+
+   host_stats_print_us("decode latency:", host_decode_latency());
+   host_stats_print_us("display latency:", host_display_latency());
+   host_stats_print_us("wake latency:", host_wake_latency());
+
+   if(NULL != trace)
+   {
+      printf("replay:           %lu frames, %lu extended frames and %lu lines skipped\n",
+             (unsigned long)replay.frames, (unsigned long)replay.extended,
+             (unsigned long)replay.skipped);
+      replay_close(&replay);
+   }
+   // the only result depending on the host, not mixed with the others
+   fprintf(stderr, "host time:        %.3f s, %.0f frames/s, %.0fx real time\n", wall,
+           (wall > 0.0) ? (host_rx_frames() / wall) : 0.0,
+           (wall > 0.0) ? ((double)hostCycles / F_CPU / wall) : 0.0);
+
+   // durations in virtual cycles, sent via telemetry, if enabled
+   host_uart_instant();
+   profiler_dump();
+   bus_stats_dump();
+   debug_flush();
+   telemetry_flush();
+   host_uart_close();
+
+   if((NULL != eeprom) && !host_eeprom_save(eeprom))
+   {
+      perror(eeprom);
+      return EXIT_FAILURE;
+   }
+
+   if((0 != threshold) &&
+      (host_stats_percentile(host_display_latency(), 990) > threshold * (F_CPU / 1000000UL)))
+   {
+      printf("FAILED: p99 of display latency exceeds %lu us\n", threshold);
+      return EXIT_FAILURE;
+   }
+
+   return EXIT_SUCCESS;
+}
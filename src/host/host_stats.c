@@ -0,0 +1,122 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file host_stats.c
+ *
+ * \date Created: 16.10.2026 22:57:16
+ * \author agent
+ **/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hal.h"
+#include "host_stats.h"
+
+// === DEFINITIONS ===========================================================
+
+//! samples allocated at first
+#define HOST_STATS_MIN_SIZE   1024
+
+//! virtual cycles per microsecond
+#define HOST_CYCLES_PER_US    (F_CPU / 1000000UL)
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief compare samples for qsort()
+ * \param a sample
+ * \param b sample
+ * \return <0, 0 or >0
+ */
+static int host_stats_compare(const void* a, const void* b)
+{
+   uint64_t x = *(const uint64_t*)a;
+   uint64_t y = *(const uint64_t*)b;
+
+   return (x > y) - (x < y);
+}
+
+// === API ===================================================================
+
+void host_stats_add(host_stats_t* stats, uint64_t value)
+{
+   uint64_t* samples;
+   size_t    size;
+
+   if(stats->count == stats->size)
+   {
+      size    = stats->size ? (stats->size * 2) : HOST_STATS_MIN_SIZE;
+      samples = realloc(stats->samples, size * sizeof(*samples));
+      if(NULL == samples)
+      {
+         fprintf(stderr, "out of memory for samples\n");
+         exit(EXIT_FAILURE);
+      }
+      stats->samples = samples;
+      stats->size    = size;
+   }
+   stats->samples[stats->count++] = value;
+   stats->sum   += value;
+   stats->sorted = false;
+}
+
+uint64_t host_stats_percentile(host_stats_t* stats, unsigned int permille)
+{
+   if(0 == stats->count)
+   {
+      return 0;
+   }
+   if(!stats->sorted)
+   {
+      qsort(stats->samples, stats->count, sizeof(*stats->samples), host_stats_compare);
+      stats->sorted = true;
+   }
+   if(permille > 1000)
+   {
+      permille = 1000;
+   }
+   // nearest rank
+   return stats->samples[((stats->count - 1) * permille + 500) / 1000];
+}
+
+uint64_t host_stats_mean(const host_stats_t* stats)
+{
+   return stats->count ? (stats->sum / stats->count) : 0;
+}
+
+void host_stats_print_us(const char* name, host_stats_t* stats)
+{
+   printf("%-18s%lu samples", name, (unsigned long)stats->count);
+   if(stats->count)
+   {
+      printf(", min %llu, mean %llu, p50 %llu, p99 %llu, max %llu us",
+             (unsigned long long)(host_stats_percentile(stats, 0) / HOST_CYCLES_PER_US),
+             (unsigned long long)(host_stats_mean(stats) / HOST_CYCLES_PER_US),
+             (unsigned long long)(host_stats_percentile(stats, 500) / HOST_CYCLES_PER_US),
+             (unsigned long long)(host_stats_percentile(stats, 990) / HOST_CYCLES_PER_US),
+             (unsigned long long)(host_stats_percentile(stats, 1000) / HOST_CYCLES_PER_US));
+   }
+   printf("\n");
+}
+
+void host_stats_free(host_stats_t* stats)
+{
+   free(stats->samples);
+   stats->samples = NULL;
+   stats->count   = 0;
+   stats->size    = 0;
+   stats->sum     = 0;
+   stats->sorted  = false;
+}
@@ -0,0 +1,83 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file host_stats.h
+ *
+ * Collects samples of the simulation (e.g. latencies in virtual cycles) and
+ * calculates their distribution.
+ *
+ * \date Created: 16.10.2026 22:57:16
+ * \author agent
+ **/
+
+
+#ifndef HOST_STATS_H_
+#define HOST_STATS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * \brief set of samples
+ */
+typedef struct
+{
+   //! samples
+   uint64_t* samples;
+   //! number of samples
+   size_t    count;
+   //! allocated samples
+   size_t    size;
+   //! sum of all samples
+   uint64_t  sum;
+   //! samples are sorted
+   bool      sorted;
+} host_stats_t;
+
+/**
+ * \brief add a sample
+ * \param stats set of samples
+ * \param value of sample
+ */
+void host_stats_add(host_stats_t* stats, uint64_t value);
+
+/**
+ * \brief get a percentile
+ * \param stats set of samples
+ * \param permille 0 (minimum) ... 1000 (maximum)
+ * \return value of percentile or 0, if there are no samples
+ */
+uint64_t host_stats_percentile(host_stats_t* stats, unsigned int permille);
+
+/**
+ * \brief get arithmetic mean
+ * \param stats set of samples
+ * \return mean or 0, if there are no samples
+ */
+uint64_t host_stats_mean(const host_stats_t* stats);
+
+/**
+ * \brief print number, min, mean, p50, p99 and max of virtual cycles in us
+ * \param name of set
+ * \param stats set of samples
+ */
+void host_stats_print_us(const char* name, host_stats_t* stats);
+
+/**
+ * \brief remove all samples
+ * \param stats set of samples
+ */
+void host_stats_free(host_stats_t* stats);
+
+#endif /* HOST_STATS_H_ */
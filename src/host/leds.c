@@ -0,0 +1,61 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file leds.c
+ *
+ * Host stub of the leds module.
+ *
+ * \date Created: 16.10.2026 22:46:35
+ * \author agent
+ **/
+
+
+#include "leds/leds.h"
+
+//! state of all LEDs
+static bool ledState[NUM_OF_LEDS];
+
+void led_init(void)
+{
+   led_all_off();
+}
+
+void led_on(eLED led)
+{
+   ledState[led] = true;
+}
+
+void led_off(eLED led)
+{
+   ledState[led] = false;
+}
+
+void led_toggle(eLED led)
+{
+   ledState[led] = !ledState[led];
+}
+
+void led_all_off(void)
+{
+   uint8_t i;
+
+   for(i = 0; i < NUM_OF_LEDS; ++i)
+   {
+      ledState[i] = false;
+   }
+}
+
+bool host_led_state(eLED led)
+{
+   return ledState[led];
+}
@@ -0,0 +1,44 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file leds/leds.h
+ *
+ * Host stub of the leds module.
+ *
+ * \date Created: 16.10.2026 22:46:35
+ * \author agent
+ **/
+
+
+#ifndef LEDS_H_
+#define LEDS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "config/leds_config.h"
+
+void led_init(void);
+void led_on(eLED led);
+void led_off(eLED led);
+void led_toggle(eLED led);
+void led_all_off(void);
+
+/**
+ * \brief get state of a simulated LED
+ * \param led to check
+ * \return true, if on
+ */
+bool host_led_state(eLED led);
+
+#endif /* LEDS_H_ */
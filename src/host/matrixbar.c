@@ -0,0 +1,131 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file matrixbar.c
+ *
+ * Host stub of the matrixbar module.
+ *
+ * \date Created: 16.10.2026 22:46:35
+ * \author agent
+ **/
+
+
+#include "hal.h"
+#include "util/util.h"
+#include "matrixbar/matrixbar.h"
+
+//! maximum number of simulated columns
+#define HOST_MATRIXBAR_COLS   8
+
+/**
+ * \brief port of the rows as given in P_MATRIXBAR_ROW
+ */
+typedef struct
+{
+   //! data direction register
+   volatile uint8_t* ddr;
+   //! port register
+   volatile uint8_t* port;
+   //! pins used
+   uint8_t           mask;
+} host_row_t;
+
+//! ports of the rows (written by the bargraph)
+static const host_row_t rows[] = { P_MATRIXBAR_ROW };
+
+//! value set to the rows
+static uint8_t rowValue       = 0;
+
+//! active columns (bit mask)
+static uint8_t activeCols     = 0;
+
+//! LEDs lit since ledSince
+static uint8_t litLeds        = 0;
+
+//! virtual time of the last change of the LEDs
+static uint64_t ledSince      = 0;
+
+//! sum of the on-time of all LEDs
+static uint64_t ledCycles     = 0;
+
+/**
+ * \brief count bits set
+ * \param value to count
+ * \return number of bits
+ */
+static uint8_t host_bits(uint8_t value)
+{
+   uint8_t count = 0;
+
+   for(; 0 != value; value &= (uint8_t)(value - 1))
+   {
+      ++count;
+   }
+   return count;
+}
+
+/**
+ * \brief account on-time of the LEDs lit up to now and take the new state
+ *
+ * The rows only change while all columns are off, so it is sufficient to
+ * call this with each change of the columns.
+ */
+static void host_matrixbar_account(void)
+{
+   uint8_t lit = 0;
+   uint8_t i;
+
+   ledCycles += (hostCycles - ledSince) * litLeds;
+   ledSince   = hostCycles;
+
+   for(i = 0; i < (sizeof(rows) / sizeof(rows[0])); ++i)
+   {
+      lit += host_bits(*rows[i].port & rows[i].mask);
+   }
+   litLeds = (uint8_t)(lit * host_bits(activeCols));
+}
+
+void matrixbar_init(void)
+{
+   matrixbar_clear();
+}
+
+void matrixbar_set(uint8_t value)
+{
+   rowValue = value;
+}
+
+void matrixbar_clear(void)
+{
+   rowValue   = 0;
+   activeCols = 0;
+   host_matrixbar_account();
+}
+
+void matrixbar_set_col(uint8_t col)
+{
+   activeCols |= (uint8_t)(1 << (col % HOST_MATRIXBAR_COLS));
+   host_matrixbar_account();
+}
+
+void matrixbar_reset_col(uint8_t col)
+{
+   activeCols &= (uint8_t)~(1 << (col % HOST_MATRIXBAR_COLS));
+   host_matrixbar_account();
+}
+
+uint64_t host_matrixbar_led_cycles(void)
+{
+   host_matrixbar_account();
+   return ledCycles;
+}
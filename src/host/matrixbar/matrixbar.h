@@ -0,0 +1,46 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file matrixbar/matrixbar.h
+ *
+ * Host stub of the matrixbar module. It records the value shown in the
+ * active column.
+ *
+ * \date Created: 16.10.2026 22:46:35
+ * \author agent
+ **/
+
+
+#ifndef MATRIXBAR_H_
+#define MATRIXBAR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "config/matrixbar_config.h"
+
+void matrixbar_init(void);
+void matrixbar_set(uint8_t value);
+void matrixbar_clear(void);
+void matrixbar_set_col(uint8_t col);
+void matrixbar_reset_col(uint8_t col);
+
+// === SIMULATION ============================================================
+
+/**
+ * \brief get on-time of all LEDs up to now
+ * \return sum of virtual cycles each LED was lit
+ */
+uint64_t host_matrixbar_led_cycles(void);
+
+#endif /* MATRIXBAR_H_ */
@@ -0,0 +1,321 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file replay.c
+ *
+ * \date Created: 16.10.2026 22:57:16
+ * \author agent
+ **/
+
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal.h"
+#include "replay.h"
+
+// === DEFINITIONS ===========================================================
+
+//! maximum length of a line of the trace
+#define REPLAY_LINE_LENGTH    256
+
+//! maximum number of tokens of a line
+#define REPLAY_MAX_TOKENS     16
+
+//! bits of a standard frame without data and stuff bits
+#define REPLAY_STD_FRAME_BITS 47
+
+//! bits of an extended frame without data and stuff bits
+#define REPLAY_EXT_FRAME_BITS 67
+
+//! highest standard id
+#define REPLAY_MAX_STD_ID     0x7FF
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief check for a token being a hex number
+ * \param token to check
+ * \param value parsed
+ * \return true, if the whole token is a hex number
+ */
+static bool replay_hex(const char* token, unsigned long* value)
+{
+   char* end;
+
+   *value = strtoul(token, &end, 16);
+   return (end != token) && ('\0' == *end);
+}
+
+/**
+ * \brief parse id and data bytes given as separate tokens
+ * \param id token of id
+ * \param len token of length
+ * \param data tokens of data bytes
+ * \param count number of data tokens
+ * \param msg frame to fill
+ * \return false, if tokens are invalid
+ */
+static bool replay_parse_bytes(const char* id, const char* len, char** data,
+                               int count, can_t* msg)
+{
+   unsigned long value;
+   int           i;
+
+   memset(msg, 0, sizeof(*msg));
+   if(!replay_hex(id, &value))
+   {
+      return false;
+   }
+   msg->msgId = (uint32_t)value;
+
+   value = strtoul(len, NULL, 10);
+   if(value > 8)
+   {
+      return false;
+   }
+   msg->header.len = (uint8_t)value;
+
+   if((count > 0) && (0 == strcmp(data[0], "remote")))
+   {
+      msg->header.rtr = 1;
+      return true;
+   }
+   if(count < msg->header.len)
+   {
+      return false;
+   }
+   for(i = 0; i < msg->header.len; ++i)
+   {
+      if(!replay_hex(data[i], &value) || (value > 0xFF))
+      {
+         return false;
+      }
+      msg->data[i] = (uint8_t)value;
+   }
+   return true;
+}
+
+/**
+ * \brief parse a line of the trace
+ * \param line to parse (modified)
+ * \param timestamp in s, if the line has one
+ * \param hasTimestamp set, if the line has a timestamp
+ * \param extended set, if the frame has an extended id
+ * \param msg frame to fill
+ * \return false, if the line contains no frame
+ */
+static bool replay_parse_line(char* line, double* timestamp, bool* hasTimestamp,
+                              bool* extended, can_t* msg)
+{
+   char*       token[REPLAY_MAX_TOKENS];
+   char*       end;
+   const char* rest;
+   size_t      idLength;
+   int         count = 0;
+   int         i     = 0;
+
+   for(end = strtok(line, " \t\r\n"); (NULL != end) && (count < REPLAY_MAX_TOKENS);
+       end = strtok(NULL, " \t\r\n"))
+   {
+      token[count++] = end;
+   }
+   if(count < 2)
+   {
+      return false;
+   }
+
+   *hasTimestamp = false;
+   *extended     = false;
+
+   if('(' == token[0][0])
+   {
+      // candump with timestamp
+      *timestamp    = strtod(token[0] + 1, NULL);
+      *hasTimestamp = true;
+      i = 1;
+   }
+   else
+   {
+      *timestamp = strtod(token[0], &end);
+      if((end != token[0]) && ('\0' == *end) && (count >= 6) &&
+         ((0 == strcmp(token[3], "Rx")) || (0 == strcmp(token[3], "Tx"))))
+      {
+         // Vector ASC: time channel id dir d|r len data...
+         *hasTimestamp = true;
+         idLength      = strlen(token[2]);
+         if(('x' == token[2][idLength - 1]) || ('X' == token[2][idLength - 1]))
+         {
+            token[2][idLength - 1] = '\0';
+            *extended = true;
+         }
+         if(!replay_parse_bytes(token[2], token[5], &token[6], count - 6, msg))
+         {
+            return false;
+         }
+         if('r' == token[4][0])
+         {
+            msg->header.rtr = 1;
+         }
+         return ('d' == token[4][0]) || ('r' == token[4][0]);
+      }
+   }
+
+   // candump: interface, then id#data or id [len] data...
+   if(count < i + 2)
+   {
+      return false;
+   }
+   rest = strchr(token[i + 1], '#');
+   if(NULL != rest)
+   {
+      // CAN FD frames (##) are not supported by the MCP2515
+      if('#' == rest[1])
+      {
+         return false;
+      }
+      idLength  = (size_t)(rest - token[i + 1]);
+      *extended = (idLength > 3);
+      rest      = replay_parse_frame(token[i + 1], msg);
+      return (NULL != rest) && ('\0' == *rest);
+   }
+
+   if((count < i + 3) || ('[' != token[i + 2][0]))
+   {
+      return false;
+   }
+   *extended = (strlen(token[i + 1]) > 3);
+   return replay_parse_bytes(token[i + 1], token[i + 2] + 1, &token[i + 3],
+                             count - i - 3, msg);
+}
+
+// === API ===================================================================
+
+const char* replay_parse_frame(const char* text, can_t* msg)
+{
+   char*    end;
+   unsigned byte;
+
+   memset(msg, 0, sizeof(*msg));
+   msg->msgId = (uint32_t)strtoul(text, &end, 16);
+   if((end == text) || ('#' != *end))
+   {
+      return NULL;
+   }
+   text = end + 1;
+
+   if(('R' == *text) || ('r' == *text))
+   {
+      msg->header.rtr = 1;
+      return text + 1;
+   }
+
+   while((msg->header.len < 8) && isxdigit((unsigned char)text[0]) &&
+         isxdigit((unsigned char)text[1]) && (1 == sscanf(text, "%2x", &byte)))
+   {
+      msg->data[msg->header.len] = (uint8_t)byte;
+      msg->header.len = msg->header.len + 1;
+      text += 2;
+   }
+   return text;
+}
+
+uint64_t replay_frame_cycles(uint32_t bitrate, bool extended, uint8_t len)
+{
+   uint32_t bits = (extended ? REPLAY_EXT_FRAME_BITS : REPLAY_STD_FRAME_BITS) + 8 * len;
+
+   return ((uint64_t)bits * F_CPU + bitrate - 1) / bitrate;
+}
+
+bool replay_open(replay_t* replay, const char* name, double speed,
+                 uint32_t bitrate, uint64_t start)
+{
+   memset(replay, 0, sizeof(*replay));
+   replay->file = fopen(name, "r");
+   if(NULL == replay->file)
+   {
+      return false;
+   }
+   replay->speed   = speed;
+   replay->bitrate = bitrate;
+   replay->start   = start;
+   replay->tail    = HOST_NO_EVENT;
+   replay->busFree = start;
+   return true;
+}
+
+bool replay_next(void* context, uint64_t* at, can_t* msg)
+{
+   replay_t* replay = (replay_t*)context;
+   char      line[REPLAY_LINE_LENGTH];
+   double    timestamp;
+   bool      hasTimestamp;
+   bool      extended;
+   uint64_t  timed;
+
+   while((NULL != replay->file) && (NULL != fgets(line, sizeof(line), replay->file)))
+   {
+      if(!replay_parse_line(line, &timestamp, &hasTimestamp, &extended, msg))
+      {
+         ++replay->skipped;
+         continue;
+      }
+
+      timed = replay->start;
+      if(hasTimestamp)
+      {
+         if(!replay->haveFirst)
+         {
+            replay->first     = timestamp;
+            replay->haveFirst = true;
+         }
+         if((replay->speed > REPLAY_SPEED_BUS) && (timestamp > replay->first))
+         {
+            timed += (uint64_t)((timestamp - replay->first) * F_CPU / replay->speed);
+         }
+      }
+
+      // frames cannot overlap on the bus
+      replay->busFree += replay_frame_cycles(replay->bitrate, extended, msg->header.len);
+      if(timed > replay->busFree)
+      {
+         replay->busFree = timed;
+      }
+
+      if(extended || (msg->msgId > REPLAY_MAX_STD_ID))
+      {
+         ++replay->extended;
+         continue;
+      }
+
+      *at = replay->busFree;
+      ++replay->frames;
+      return true;
+   }
+
+   if(HOST_NO_EVENT != replay->tail)
+   {
+      host_set_end(replay->busFree + replay->tail);
+   }
+   return false;
+}
+
+void replay_close(replay_t* replay)
+{
+   if(NULL != replay->file)
+   {
+      fclose(replay->file);
+      replay->file = NULL;
+   }
+}
@@ -0,0 +1,120 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file replay.h
+ *
+ * Replay of recorded CAN traces on the simulated bus. The trace is read line
+ * by line while the simulation runs, so traces of any size can be used.
+ *
+ * Supported formats (detected per line):
+ * - candump log file:  (1436509052.249713) can0 54B#0102030405060708
+ * - candump output:    (1436509052.249713)  can0  54B   [8]  01 02 ...
+ *                      can0  54B   [8]  01 02 ...
+ * - Vector ASC:        0.012345 1  54B  Rx   d 8 01 02 ...
+ *
+ * Extended frames are skipped, since the PDC uses standard ids only. They
+ * still occupy the bus.
+ *
+ * \date Created: 16.10.2026 22:57:16
+ * \author agent
+ **/
+
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "can/can_mcp2515.h"
+
+/**
+ * \brief speed factor: frames follow each other as fast as the bus allows
+ */
+#define REPLAY_SPEED_BUS      0.0
+
+/**
+ * \brief state of a replay
+ */
+typedef struct
+{
+   //! trace file
+   FILE*    file;
+   //! speed factor of the original timing or REPLAY_SPEED_BUS
+   double   speed;
+   //! bitrate of the bus in bit/s
+   uint32_t bitrate;
+   //! virtual time of the first frame
+   uint64_t start;
+   //! time after the last frame to end the simulation or HOST_NO_EVENT
+   uint64_t tail;
+   //! timestamp of first frame in s
+   double   first;
+   //! first timestamp is known
+   bool     haveFirst;
+   //! virtual time the bus is free again
+   uint64_t busFree;
+   //! frames given to the bus
+   uint32_t frames;
+   //! extended frames skipped
+   uint32_t extended;
+   //! lines not containing a frame
+   uint32_t skipped;
+} replay_t;
+
+/**
+ * \brief parse a frame given in candump notation
+ * \param text e.g. "54B#0102030405060708" or "54B#R"
+ * \param msg frame to fill
+ * \return pointer behind parsed text or NULL on error
+ */
+const char* replay_parse_frame(const char* text, can_t* msg);
+
+/**
+ * \brief get virtual cycles a frame occupies the bus (without stuff bits)
+ * \param bitrate of the bus in bit/s
+ * \param extended id
+ * \param len number of data bytes
+ * \return cycles
+ */
+uint64_t replay_frame_cycles(uint32_t bitrate, bool extended, uint8_t len);
+
+/**
+ * \brief open a trace for replay
+ * \param replay state to init
+ * \param name of trace file
+ * \param speed factor of the original timing or REPLAY_SPEED_BUS
+ * \param bitrate of the bus in bit/s
+ * \param start virtual time of the first frame
+ * \return false, if the trace cannot be opened
+ */
+bool replay_open(replay_t* replay, const char* name, double speed,
+                 uint32_t bitrate, uint64_t start);
+
+/**
+ * \brief get next frame of the trace (host_can_source_t)
+ * \param context replay state
+ * \param at virtual time of reception
+ * \param msg frame to fill
+ * \return false, if the trace is exhausted
+ */
+bool replay_next(void* context, uint64_t* at, can_t* msg);
+
+/**
+ * \brief close trace
+ * \param replay state
+ */
+void replay_close(replay_t* replay);
+
+#endif /* REPLAY_H_ */
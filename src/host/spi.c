@@ -0,0 +1,41 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file spi.c
+ *
+ * Host stub of the spi module. The bytes are passed to the simulated
+ * MCP2515 selected, each takes HOST_SPI_CYCLES_PER_BYTE of virtual time.
+ *
+ * \date Created: 16.10.2026 22:46:35
+ * \author agent
+ **/
+
+
+#include "hal.h"
+#include "can/can_mcp2515.h"
+
+void spi_pin_init(void)
+{
+}
+
+void spi_master_init(void)
+{
+}
+
+uint8_t spi_putc(uint8_t data)
+{
+   // the byte is shifted out while polling SPIF
+   host_advance(HOST_SPI_CYCLES_PER_BYTE);
+   // the only SPI devices are the MCP2515s
+   return host_can_spi_transfer(data);
+}
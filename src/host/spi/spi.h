@@ -0,0 +1,34 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file spi/spi.h
+ *
+ * Host stub of the spi module.
+ *
+ * \date Created: 16.10.2026 22:46:35
+ * \author agent
+ **/
+
+
+#ifndef SPI_H_
+#define SPI_H_
+
+#include <stdint.h>
+
+#include "config/spi_config.h"
+
+void spi_pin_init(void);
+void spi_master_init(void);
+uint8_t spi_putc(uint8_t data);
+
+#endif /* SPI_H_ */
@@ -0,0 +1,467 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file telemetry_tool.c
+ *
+ * Decodes the records sent by the telemetry (see telemetry.h), captured
+ * from the UART of the AVR or written by PDCViewerHost -u. E.g.
+ *
+ * \code
+ * stty -F /dev/ttyUSB0 250000 raw && PDCTelemetry /dev/ttyUSB0
+ * \endcode
+ *
+ * The time of the records is unwrapped, as long as records follow each
+ * other within ~16.7s (the statistics are sent each second while running).
+ *
+ * \date Created: 16.10.2026 23:51:05
+ * \author agent
+ **/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "hal.h"
+#include "profiler.h"
+#include "telemetry.h"
+#include "PDCViewer.h"
+
+// === DEFINITIONS ===========================================================
+
+//! largest frame accepted (decoded)
+#define TOOL_FRAME_MAX           256
+
+//! record types counted (0 is invalid)
+#define TOOL_NUM_OF_TYPES        (TELEMETRY_PROFILE + 1)
+
+//! controllers of the statistics at most
+#define TOOL_MAX_CHIPS           8
+
+/**
+ * \brief state of the decoder
+ */
+typedef struct
+{
+   //! print records, not only the summary
+   bool     verbose;
+   //! bytes read
+   uint64_t bytes;
+   //! frames not decoded (COBS error, too short or unknown type)
+   uint64_t invalid;
+   //! records per type
+   uint64_t records[TOOL_NUM_OF_TYPES];
+   //! records missing by the sequence numbers
+   uint64_t lost;
+   //! a record was decoded before
+   bool     synced;
+   //! sequence number expected next
+   uint8_t  sequence;
+   //! time of the first record in ticks
+   uint64_t first;
+   //! time of the last record in ticks (unwrapped)
+   uint64_t now;
+   //! a record with time was decoded
+   bool     timed;
+   //! last counters of the statistics per controller (frames, dropped, overflows)
+   uint16_t stats[TOOL_MAX_CHIPS][3];
+   //! last records dropped by the AVR
+   uint16_t dropped;
+   //! statistics received before
+   bool     statsValid;
+   //! text is not at the start of a line
+   bool     inText;
+} tool_t;
+
+//! names of the states of the FSM
+static const char* const stateNames[NUM_OF_STATES] =
+{
+   "INIT", "RUNNING", "SLEEP_DETECTED", "SLEEPING", "WAKEUP", "ERROR"
+};
+
+//! names of the probes of the profiler
+static const char probeNames[NUM_OF_PROBES][PROFILER_NAME_SIZE] =
+{
+   PROFILER_PROBE_NAMES
+};
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief print usage
+ * \param name of program
+ */
+static void usage(const char* name)
+{
+   fprintf(stderr,
+           "usage: %s [-s] [file]\n"
+           "  -s     print the summary only\n"
+           "  file   stream of the UART (default stdin)\n",
+           name);
+}
+
+/**
+ * \brief get 16bit value (little endian)
+ * \param data first byte
+ * \return value
+ */
+static uint16_t get16(const uint8_t* data)
+{
+   return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+/**
+ * \brief get 32bit value (little endian)
+ * \param data first byte
+ * \return value
+ */
+static uint32_t get32(const uint8_t* data)
+{
+   return (uint32_t)get16(data) | ((uint32_t)get16(data + 2) << 16);
+}
+
+/**
+ * \brief convert ticks of systick.h to ms
+ * \param ticks to convert
+ * \return ms
+ */
+static double ticks_ms(uint64_t ticks)
+{
+   return (double)ticks * 1024.0 * 1000.0 / F_CPU;
+}
+
+/**
+ * \brief decode a frame (COBS)
+ * \param frame encoded, without delimiter
+ * \param length of the frame
+ * \param record decoded
+ * \return length of the record or -1 on error
+ */
+static int cobs_decode(const uint8_t* frame, int length, uint8_t* record)
+{
+   int     in  = 0;
+   int     out = 0;
+   uint8_t code;
+   uint8_t i;
+
+   while(in < length)
+   {
+      code = frame[in++];
+      if((0 == code) || (in + code - 1 > length))
+      {
+         return -1;
+      }
+      for(i = 1; i < code; ++i)
+      {
+         record[out++] = frame[in++];
+      }
+      // the zero implied by the last block is not part of the record
+      if((TELEMETRY_CODE_MAX != code) && (in < length))
+      {
+         record[out++] = 0;
+      }
+   }
+   return out;
+}
+
+/**
+ * \brief take the time of a record
+ * \param tool decoder
+ * \param ticks time of the record (wraps around)
+ */
+static void take_time(tool_t* tool, uint16_t ticks)
+{
+   if(!tool->timed)
+   {
+      tool->first = ticks;
+      tool->now   = ticks;
+      tool->timed = true;
+   }
+   else
+   {
+      tool->now += (uint16_t)(ticks - (uint16_t)tool->now);
+   }
+   if(tool->verbose)
+   {
+      printf("%10.1f ms  ", ticks_ms(tool->now - tool->first));
+   }
+}
+
+/**
+ * \brief print counters of the statistics
+ * \param tool decoder
+ * \param data payload after the time
+ * \param chips number of controllers
+ */
+static void print_stats(tool_t* tool, const uint8_t* data, int chips)
+{
+   uint16_t value;
+   int      chip;
+   int      i;
+
+   for(chip = 0; chip < chips; ++chip)
+   {
+      if(tool->verbose)
+      {
+         printf("%sbus %d", (0 != chip) ? ", " : "stats     ", chip + 1);
+      }
+      for(i = 0; i < 3; ++i)
+      {
+         value = get16(data + chip * 6 + i * 2);
+         if(tool->verbose)
+         {
+            // counters wrap around, the change is shown
+            printf(" %c%u", "fdo"[i],
+                   tool->statsValid ? (uint16_t)(value - tool->stats[chip][i]) : value);
+         }
+         tool->stats[chip][i] = value;
+      }
+   }
+   value = get16(data + chips * 6);
+   if(tool->verbose)
+   {
+      printf(", records dropped %u\n",
+             tool->statsValid ? (uint16_t)(value - tool->dropped) : value);
+   }
+   tool->dropped    = value;
+   tool->statsValid = true;
+}
+
+/**
+ * \brief decode and print a record
+ * \param tool decoder
+ * \param record decoded
+ * \param length of the record
+ * \return false, if the record is invalid
+ */
+static bool print_record(tool_t* tool, const uint8_t* record, int length)
+{
+   const uint8_t* data = record + TELEMETRY_HEADER;
+   int            size = length - TELEMETRY_HEADER;
+   uint32_t       count;
+   int            i;
+
+   if((size < 0) || (0 == record[0]) || (record[0] >= TOOL_NUM_OF_TYPES))
+   {
+      return false;
+   }
+
+   // records missing since the last one
+   if(tool->synced)
+   {
+      tool->lost += (uint8_t)(record[1] - tool->sequence);
+   }
+   tool->sequence = (uint8_t)(record[1] + 1);
+   tool->synced   = true;
+
+   if(tool->inText && (TELEMETRY_TEXT != record[0]))
+   {
+      // text cut off, e.g. dropped
+      if(tool->verbose)
+      {
+         putchar('\n');
+      }
+      tool->inText = false;
+   }
+
+   switch(record[0])
+   {
+      case TELEMETRY_TEXT:
+      {
+         for(i = 0; tool->verbose && (i < size); ++i)
+         {
+            if('\r' != data[i])
+            {
+               putchar(data[i]);
+            }
+         }
+         tool->inText = (size > 0) && ('\n' != data[size - 1]);
+         break;
+      }
+
+      case TELEMETRY_STATE:
+      {
+         if((3 != size) || (data[2] >= NUM_OF_STATES))
+         {
+            return false;
+         }
+         take_time(tool, get16(data));
+         if(tool->verbose)
+         {
+            printf("state     %s\n", stateNames[data[2]]);
+         }
+         break;
+      }
+
+      case TELEMETRY_DISTANCES:
+      {
+         if(size < 3)
+         {
+            return false;
+         }
+         take_time(tool, get16(data));
+         if(tool->verbose)
+         {
+            printf("distances slots 0x%02X:", data[2]);
+            for(i = 3; i < size; ++i)
+            {
+               printf(" %3u", data[i]);
+            }
+            putchar('\n');
+         }
+         break;
+      }
+
+      case TELEMETRY_STATS:
+      {
+         if((size < 10) || (0 != (size - 4) % 6) || ((size - 4) / 6 > TOOL_MAX_CHIPS))
+         {
+            return false;
+         }
+         take_time(tool, get16(data));
+         print_stats(tool, data + 2, (size - 4) / 6);
+         break;
+      }
+
+      case TELEMETRY_PROFILE:
+      {
+         if((13 != size) || (data[0] >= NUM_OF_PROBES))
+         {
+            return false;
+         }
+         count = get32(data + 1);
+         if(tool->verbose)
+         {
+            printf("profile   %s %10lu %6u %6u %6lu\n", probeNames[data[0]],
+                   (unsigned long)count, get16(data + 5), get16(data + 7),
+                   (unsigned long)((0 != count) ? (get32(data + 9) / count) : 0));
+         }
+         break;
+      }
+
+      default:
+      {
+         return false;
+      }
+   }
+
+   ++tool->records[record[0]];
+   return true;
+}
+
+// === MAIN ==================================================================
+
+int main(int argc, char** argv)
+{
+   static const char* const typeNames[TOOL_NUM_OF_TYPES] =
+   {
+      "", "text", "state", "distances", "stats", "profile"
+   };
+   uint8_t  frame[TOOL_FRAME_MAX];
+   uint8_t  record[TOOL_FRAME_MAX];
+   tool_t   tool;
+   FILE*    file = stdin;
+   uint64_t total = 0;
+   bool     first = true;
+   double   span;
+   int      length = 0;
+   int      size;
+   int      c;
+   int      opt;
+
+   memset(&tool, 0, sizeof(tool));
+   tool.verbose = true;
+
+   while(-1 != (opt = getopt(argc, argv, "sh")))
+   {
+      switch(opt)
+      {
+         case 's':
+         {
+            tool.verbose = false;
+            break;
+         }
+
+         default:
+         {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+         }
+      }
+   }
+   if(optind + 1 < argc)
+   {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+   }
+   if((optind < argc) && (NULL == (file = fopen(argv[optind], "rb"))))
+   {
+      perror(argv[optind]);
+      return EXIT_FAILURE;
+   }
+
+   while(EOF != (c = fgetc(file)))
+   {
+      ++tool.bytes;
+      if(TELEMETRY_DELIMITER != c)
+      {
+         // too long: no delimiter seen, e.g. not synchronized yet
+         if(length < TOOL_FRAME_MAX)
+         {
+            frame[length] = (uint8_t)c;
+         }
+         ++length;
+         continue;
+      }
+
+      // the capture may start within a frame
+      size = (length <= TOOL_FRAME_MAX) ? cobs_decode(frame, length, record) : -1;
+      if((0 != length) && ((size < 0) || !print_record(&tool, record, size)) && !first)
+      {
+         ++tool.invalid;
+      }
+      first  = false;
+      length = 0;
+   }
+   if(stdin != file)
+   {
+      fclose(file);
+   }
+   if(tool.inText && tool.verbose)
+   {
+      putchar('\n');
+   }
+
+   printf("bytes:   %llu, %llu invalid frames\n",
+          (unsigned long long)tool.bytes, (unsigned long long)tool.invalid);
+   printf("records:");
+   for(opt = 1; opt < TOOL_NUM_OF_TYPES; ++opt)
+   {
+      printf(" %llu %s%s", (unsigned long long)tool.records[opt], typeNames[opt],
+             (TOOL_NUM_OF_TYPES - 1 != opt) ? "," : "");
+      total += tool.records[opt];
+   }
+   printf("\nlost:    %llu records (%.2f %%)\n", (unsigned long long)tool.lost,
+          (0 != total + tool.lost) ? (100.0 * tool.lost / (total + tool.lost)) : 0.0);
+
+   // time only passes while running, i.e. not while powered down
+   span = ticks_ms(tool.now - tool.first);
+   if(span > 0.0)
+   {
+      printf("rate:    %.0f bytes/s, %.1f records/s over %.1f s running\n",
+             1000.0 * tool.bytes / span, 1000.0 * total / span, span / 1000.0);
+   }
+
+   return (0 == tool.invalid) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
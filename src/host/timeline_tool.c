@@ -0,0 +1,279 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file timeline_tool.c
+ *
+ * Shows the events saved by the flight recorder (see recorder.h) as a
+ * timeline, read from an EEPROM image of the AVR or written by
+ * PDCViewerHost -e. E.g.
+ *
+ * \code
+ * avrdude -p m8 -c usbasp -U eeprom:r:image.bin:r && PDCTimeline image.bin
+ * \endcode
+ *
+ * The time is shown relative to saving. It is unwrapped backwards from the
+ * newest event, as long as events follow each other within ~16.7s. The
+ * systick stops while powered down, so time spent sleeping is not shown.
+ *
+ * \date Created: 16.10.2026 23:56:07
+ * \author agent
+ **/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal.h"
+#include "recorder.h"
+#include "PDCViewer.h"
+
+// === DEFINITIONS ===========================================================
+
+//! lanes of the timeline
+enum
+{
+   LANE_FSM = 0,
+   LANE_TIMER1,
+   LANE_TIMER2,
+   LANE_INT0,
+   LANE_CAN,
+   NUM_OF_LANES
+};
+
+//! names of the states of the FSM
+static const char* const stateNames[NUM_OF_STATES] =
+{
+   "INIT", "RUNNING", "SLEEP_DETECTED", "SLEEPING", "WAKEUP", "ERROR"
+};
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief print usage
+ * \param name of program
+ */
+static void usage(const char* name)
+{
+   fprintf(stderr,
+           "usage: %s image\n"
+           "  image  EEPROM image, e.g. written by PDCViewerHost -e\n",
+           name);
+}
+
+/**
+ * \brief get 16bit value (little endian)
+ * \param data first byte
+ * \return value
+ */
+static uint16_t get16(const uint8_t* data)
+{
+   return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+/**
+ * \brief convert ticks of systick.h to ms
+ * \param ticks to convert
+ * \return ms
+ */
+static double ticks_ms(int64_t ticks)
+{
+   return (double)ticks * 1024.0 * 1000.0 / F_CPU;
+}
+
+/**
+ * \brief get name of a state
+ * \param state of the FSM
+ * \return name
+ */
+static const char* state_name(uint16_t state)
+{
+   return (state < NUM_OF_STATES) ? stateNames[state] : "?";
+}
+
+/**
+ * \brief print an event
+ * \param entry of the image (event, count, value, time)
+ * \param ticks time relative to saving
+ */
+static void print_event(const uint8_t* entry, int64_t ticks)
+{
+   uint16_t value = get16(entry + 2);
+   int      lane;
+   int      i;
+
+   switch(entry[0])
+   {
+      case RECORDER_STATE:
+      case RECORDER_ERROR:
+      case RECORDER_INIT_FAILED:
+      {
+         lane = LANE_FSM;
+         break;
+      }
+
+      case RECORDER_TIMER1:
+      {
+         lane = LANE_TIMER1;
+         break;
+      }
+
+      case RECORDER_TIMER2:
+      {
+         lane = LANE_TIMER2;
+         break;
+      }
+
+      case RECORDER_INT0:
+      {
+         lane = LANE_INT0;
+         break;
+      }
+
+      default:
+      {
+         lane = LANE_CAN;
+         break;
+      }
+   }
+
+   printf("%10.1f ms  ", ticks_ms(ticks));
+   for(i = 0; i < NUM_OF_LANES; ++i)
+   {
+      printf("%s", (i == lane) ? "*   " : "|   ");
+   }
+
+   switch(entry[0])
+   {
+      case RECORDER_STATE:
+      {
+         printf("state %s", state_name(value));
+         break;
+      }
+
+      case RECORDER_TIMER1:
+      {
+         printf("bus silent");
+         break;
+      }
+
+      case RECORDER_TIMER2:
+      {
+         printf("display");
+         break;
+      }
+
+      case RECORDER_INT0:
+      {
+         printf("frames received%s", (0 != value) ? "" : ", none queued");
+         break;
+      }
+
+      case RECORDER_FRAME:
+      {
+         printf("frame 0x%03X", value);
+         break;
+      }
+
+      case RECORDER_INIT_FAILED:
+      {
+         printf("controller %u not initialized", value + 1);
+         break;
+      }
+
+      case RECORDER_ERROR:
+      {
+         printf("error, state before %s", state_name(value));
+         break;
+      }
+
+      default:
+      {
+         printf("unknown event %u (%u)", entry[0], value);
+         break;
+      }
+   }
+   if(entry[1] > 1)
+   {
+      printf(" x%u", entry[1]);
+   }
+   putchar('\n');
+}
+
+// === MAIN ==================================================================
+
+int main(int argc, char** argv)
+{
+   uint8_t        image[E2END + 1];
+   const uint8_t* data = &image[RECORDER_ADDR];
+   const uint8_t* entry;
+   int64_t        times[RECORDER_SIZE];
+   uint16_t       crc  = RECORDER_CRC_INIT;
+   uint16_t       later;
+   int64_t        ticks;
+   FILE*          file;
+   size_t         size;
+   int            used;
+   int            i;
+
+   if(2 != argc)
+   {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+   }
+   if(NULL == (file = fopen(argv[1], "rb")))
+   {
+      perror(argv[1]);
+      return EXIT_FAILURE;
+   }
+   memset(image, 0xFF, sizeof(image));
+   (void)fread(image, 1, sizeof(image), file);
+   fclose(file);
+
+   used = data[1];
+   if((RECORDER_VERSION != data[0]) || (used > RECORDER_SIZE))
+   {
+      fprintf(stderr, "%s: no events recorded\n", argv[1]);
+      return EXIT_FAILURE;
+   }
+   size = RECORDER_HEADER_SIZE + (size_t)used * RECORDER_ENTRY_SIZE;
+   for(i = 0; i < (int)size; ++i)
+   {
+      crc = hal_crc_ccitt_update(crc, data[i]);
+   }
+   if(crc != get16(data + size))
+   {
+      fprintf(stderr, "%s: CRC of the events invalid\n", argv[1]);
+      return EXIT_FAILURE;
+   }
+
+   printf("%d events, time relative to saving\n\n", used);
+   printf("      time     FSM T1  T2  INT CAN\n");
+
+   // newest first to unwrap the time, printed oldest first
+   later = get16(data + 2);
+   ticks = 0;
+   for(i = used - 1; i >= 0; --i)
+   {
+      entry    = data + RECORDER_HEADER_SIZE + i * RECORDER_ENTRY_SIZE;
+      ticks   -= (uint16_t)(later - get16(entry + 4));
+      later    = get16(entry + 4);
+      times[i] = ticks;
+   }
+   for(i = 0; i < used; ++i)
+   {
+      print_event(data + RECORDER_HEADER_SIZE + i * RECORDER_ENTRY_SIZE, times[i]);
+   }
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,185 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file timer.c
+ *
+ * Host stub of the timer module. Timer1 and Timer2 run in CTC mode with
+ * the compare values of timer_config.h.
+ *
+ * \date Created: 16.10.2026 22:46:35
+ * \author agent
+ **/
+
+
+#include "hal.h"
+#include "timer/timer.h"
+
+/**
+ * \brief simulated timer
+ */
+typedef struct
+{
+   //! timer is running
+   bool     running;
+   //! virtual time of count 0
+   uint64_t base;
+   //! prescaler
+   uint16_t prescaler;
+   //! compare value (TOP)
+   uint16_t top;
+   //! interrupt flag
+   bool     pending;
+} host_timer_t;
+
+//! Timer1 (bus sleep detection)
+static host_timer_t timer1;
+//! Timer2 (display multiplexing)
+static host_timer_t timer2;
+
+/**
+ * \brief prescaler of Timer1 by clock select bits
+ */
+static const uint16_t timer1Prescaler[8] = {0, 1, 8, 64, 256, 1024, 0, 0};
+
+/**
+ * \brief prescaler of Timer2 by clock select bits
+ */
+static const uint16_t timer2Prescaler[8] = {0, 1, 8, 32, 64, 128, 256, 1024};
+
+/**
+ * \brief cycles of a full compare period
+ * \param t timer
+ * \return cycles
+ */
+static uint64_t host_timer_period(const host_timer_t* t)
+{
+   return ((uint64_t)t->top + 1) * t->prescaler;
+}
+
+/**
+ * \brief get next compare match of a timer
+ * \param t timer
+ * \return virtual time or HOST_NO_EVENT
+ */
+static uint64_t host_timer_next(const host_timer_t* t)
+{
+   return (t->running) ? t->base + host_timer_period(t) : HOST_NO_EVENT;
+}
+
+/**
+ * \brief update a timer and set its interrupt flag on compare match
+ * \param t timer
+ */
+static void host_timer_run(host_timer_t* t)
+{
+   while(t->running && (host_timer_next(t) <= hostCycles))
+   {
+      t->base   += host_timer_period(t);
+      t->pending = true;
+   }
+}
+
+// === MODULE API ============================================================
+
+void initTimer1(eTimerMode mode)
+{
+   (void)mode;
+   timer1.prescaler = timer1Prescaler[(TIMER1_PRESCALER) & 0x07];
+   timer1.top       = TIMER1_COMPARE_VALUE;
+   restartTimer1();
+}
+
+void stopTimer1(void)
+{
+   timer1.running = false;
+}
+
+void restartTimer1(void)
+{
+   timer1.base    = hostCycles;
+   timer1.running = true;
+}
+
+void setTimer1Count(uint16_t value)
+{
+   timer1.base = hostCycles - (uint64_t)value * timer1.prescaler;
+}
+
+void initTimer2(eTimerMode mode)
+{
+   (void)mode;
+   timer2.prescaler = timer2Prescaler[(TIMER2_PRESCALER) & 0x07];
+   timer2.top       = TIMER2_COMPARE_VALUE;
+   restartTimer2();
+}
+
+void stopTimer2(void)
+{
+   timer2.running = false;
+}
+
+void restartTimer2(void)
+{
+   timer2.base    = hostCycles;
+   timer2.running = true;
+}
+
+// === SIMULATION ============================================================
+
+uint8_t host_timer2_ocr(void)
+{
+   return (uint8_t)timer2.top;
+}
+
+void host_timer2_write_ocr(uint8_t value)
+{
+   timer2.top = value;
+}
+
+uint16_t host_timer1_tcnt(void)
+{
+   return (timer1.running) ? (uint16_t)((hostCycles - timer1.base) / timer1.prescaler) : 0;
+}
+
+void host_timer1_write_icr(uint16_t value)
+{
+   timer1.top = value;
+}
+
+uint64_t host_timer_next_event(void)
+{
+   uint64_t next1 = host_timer_next(&timer1);
+   uint64_t next2 = host_timer_next(&timer2);
+
+   return (next1 < next2) ? next1 : next2;
+}
+
+void host_timer_update(void)
+{
+   host_timer_run(&timer1);
+   host_timer_run(&timer2);
+}
+
+bool host_timer1_irq_take(void)
+{
+   bool pending = timer1.pending;
+   timer1.pending = false;
+   return pending;
+}
+
+bool host_timer2_irq_take(void)
+{
+   bool pending = timer2.pending;
+   timer2.pending = false;
+   return pending;
+}
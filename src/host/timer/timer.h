@@ -0,0 +1,81 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file timer/timer.h
+ *
+ * Host stub of the timer module. Prescaler and compare values are taken
+ * from timer_config.h.
+ *
+ * \date Created: 16.10.2026 22:46:35
+ * \author agent
+ **/
+
+
+#ifndef TIMER_H_
+#define TIMER_H_
+
+#include <stdint.h>
+
+#include "config/timer_config.h"
+
+/**
+ * \brief timer modes
+ */
+typedef enum
+{
+   TimerOverflow  = 0,
+   TimerCompare   = 1
+} eTimerMode;
+
+void initTimer1(eTimerMode mode);
+void stopTimer1(void);
+void restartTimer1(void);
+void setTimer1Count(uint16_t value);
+
+void initTimer2(eTimerMode mode);
+void stopTimer2(void);
+void restartTimer2(void);
+
+// === SIMULATION ============================================================
+
+/**
+ * \brief read compare register of Timer2 (OCR2)
+ * \return compare value
+ */
+uint8_t host_timer2_ocr(void);
+
+/**
+ * \brief write compare register of Timer2 (OCR2)
+ *
+ * The next compare match is calculated from the last one (CTC mode).
+ *
+ * \param value compare value
+ */
+void host_timer2_write_ocr(uint8_t value);
+
+/**
+ * \brief read count of Timer1 (TCNT1)
+ * \return count
+ */
+uint16_t host_timer1_tcnt(void);
+
+/**
+ * \brief write TOP of Timer1 (ICR1)
+ *
+ * The next compare match is calculated from the last one (CTC mode).
+ *
+ * \param value compare value
+ */
+void host_timer1_write_icr(uint16_t value);
+
+#endif /* TIMER_H_ */
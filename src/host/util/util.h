@@ -0,0 +1,56 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file util/util.h
+ *
+ * Host stub of the util module. Only the port access used by the
+ * configuration files is provided.
+ *
+ * \date Created: 16.10.2026 22:46:35
+ * \author agent
+ **/
+
+
+#ifndef UTIL_H_
+#define UTIL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "host_io.h"
+
+//! get PORT register
+#define PORT(x)               _port2(x)
+//! get DDR register
+#define DDR(x)                _ddr2(x)
+
+#define _port2(x)             PORT ## x
+#define _ddr2(x)              DDR ## x
+
+/**
+ * \brief port access structure
+ */
+typedef struct
+{
+   //! data direction register
+   volatile uint8_t* ddr;
+   //! port register
+   volatile uint8_t* port;
+   //! pin number
+   uint8_t           pin;
+} portaccess_t;
+
+//! initialize port access structure
+#define SET_PORT_PTR(p, b)    {&DDR(p), &PORT(p), b}
+
+#endif /* UTIL_H_ */
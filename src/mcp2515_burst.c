@@ -0,0 +1,165 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file mcp2515_burst.c
+ *
+ * \date Created: 16.10.2026 22:49:44
+ * \author agent
+ **/
+
+
+#include "hal.h"
+#include "mcp2515_burst.h"
+
+// === GLOBALS ===============================================================
+
+//! receive buffer overflows per controller and buffer
+static uint16_t rxOverflows[NUM_OF_MCP2515][MCP2515_NUM_OF_RXB];
+
+// === FUNCTIONS =============================================================
+
+void mcp2515_rx_setup(eChipSelect chip)
+{
+   // RXB0 full -> RXB1
+   bit_modify_mcp2515(chip, RXB0CTRL, (1 << BUKT), (1 << BUKT));
+   // overflows are signalled by ERRIF
+   bit_modify_mcp2515(chip, CANINTE, (1 << ERRIE), (1 << ERRIE));
+}
+
+uint8_t mcp2515_rx_status(eChipSelect chip)
+{
+   uint8_t status;
+
+   hal_can_select(chip);
+   spi_putc(MCP2515_RX_STATUS);
+   status = spi_putc(0xFF);
+   hal_can_deselect(chip);
+
+   return status & (MCP2515_RXB0_FULL | MCP2515_RXB1_FULL);
+}
+
+void mcp2515_read_rx_buffer(eChipSelect chip, uint8_t buffer, can_t* msg)
+{
+   uint8_t sidl;
+   uint8_t len;
+   uint8_t i;
+
+   hal_can_select(chip);
+   // n = 0 (RXBnSIDH), m = buffer
+   spi_putc(MCP2515_READ_RX_BUFFER | (uint8_t)(buffer << 2));
+   // SIDH: bits 3..10 of CAN ID @ bits 0..7
+   msg->msgId      = (uint32_t)spi_putc(0xFF) << 3;
+   // SIDL: bits 0..2 of CAN ID @ bits 5..7, SRR @ bit 4
+   sidl            = spi_putc(0xFF);
+   msg->msgId     |= sidl >> 5;
+   msg->header.rtr = (sidl & 0x10) ? 1 : 0;
+   // EID8, EID0 - standard frames only
+   spi_putc(0xFF);
+   spi_putc(0xFF);
+   // DLC
+   len = spi_putc(0xFF) & 0x0F;
+   if(len > 8)
+   {
+      len = 8;
+   }
+   msg->header.len = len;
+   for(i = 0; i < len; ++i)
+   {
+      msg->data[i] = spi_putc(0xFF);
+   }
+   // releasing CS clears RXnIF
+   hal_can_deselect(chip);
+}
+
+void mcp2515_load_tx_buffer(eChipSelect chip, uint8_t buffer, const can_t* msg)
+{
+   uint8_t i;
+
+   hal_can_select(chip);
+   // start at TXBnSIDH
+   spi_putc(MCP2515_LOAD_TX_BUFFER | (uint8_t)(buffer << 1));
+   // SIDH, SIDL (standard frame), EID8, EID0
+   spi_putc((uint8_t)(msg->msgId >> 3));
+   spi_putc((uint8_t)(msg->msgId << 5));
+   spi_putc(0);
+   spi_putc(0);
+   // DLC with RTR bit
+   spi_putc((uint8_t)(msg->header.len | (msg->header.rtr ? 0x40 : 0x00)));
+   for(i = 0; i < msg->header.len; ++i)
+   {
+      spi_putc(msg->data[i]);
+   }
+   hal_can_deselect(chip);
+}
+
+void mcp2515_read_burst(eChipSelect chip, uint8_t address, uint8_t* data, uint8_t length)
+{
+   hal_can_select(chip);
+   spi_putc(MCP2515_READ);
+   spi_putc(address);
+   while(length-- > 0)
+   {
+      *data++ = spi_putc(0xFF);
+   }
+   hal_can_deselect(chip);
+}
+
+void mcp2515_write_burst(eChipSelect chip, uint8_t address, const uint8_t* data, uint8_t length)
+{
+   hal_can_select(chip);
+   spi_putc(MCP2515_WRITE);
+   spi_putc(address);
+   while(length-- > 0)
+   {
+      spi_putc(*data++);
+   }
+   hal_can_deselect(chip);
+}
+
+bool mcp2515_rx_check_overflow(eChipSelect chip)
+{
+   uint8_t eflg;
+
+   if(0 == (read_register_mcp2515(chip, CANINTF) & (1 << ERRIF)))
+   {
+      return false;
+   }
+
+   eflg = read_register_mcp2515(chip, EFLG);
+   if(eflg & (1 << RX0OVR))
+   {
+      ++rxOverflows[chip][0];
+   }
+   if(eflg & (1 << RX1OVR))
+   {
+      ++rxOverflows[chip][1];
+   }
+   // overflow flags need to be cleared by the MCU
+   bit_modify_mcp2515(chip, EFLG, (1 << RX0OVR) | (1 << RX1OVR), 0);
+   bit_modify_mcp2515(chip, CANINTF, (1 << ERRIF), 0);
+
+   return true;
+}
+
+uint16_t mcp2515_rx_overflows(eChipSelect chip, uint8_t buffer)
+{
+   uint16_t count;
+   uint8_t  state;
+
+   // 16bit value written by the ISR
+   state = hal_irq_save();
+   count = rxOverflows[chip][buffer];
+   hal_irq_restore(state);
+
+   return count;
+}
@@ -0,0 +1,139 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file mcp2515_burst.h
+ *
+ * Fast SPI access to the MCP2515 not covered by the can module. The
+ * receive path uses the "RX STATUS" and "READ RX BUFFER" instructions,
+ * which need no address byte and clear the interrupt flag of the buffer
+ * when the chip select is released.
+ *
+ * \date Created: 16.10.2026 22:49:44
+ * \author agent
+ **/
+
+
+#ifndef MCP2515_BURST_H_
+#define MCP2515_BURST_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "can/can_mcp2515.h"
+
+// === DEFINITIONS ===========================================================
+
+//! SPI instruction: write registers starting at address (auto increment)
+#define MCP2515_WRITE            0x02
+//! SPI instruction: read registers starting at address (auto increment)
+#define MCP2515_READ             0x03
+//! SPI instruction: load TX buffer n starting at TXBnSIDH
+#define MCP2515_LOAD_TX_BUFFER   0x40
+//! SPI instruction: read RX buffer n starting at RXBnSIDH
+#define MCP2515_READ_RX_BUFFER   0x90
+//! SPI instruction: quick status of the receive buffers
+#define MCP2515_RX_STATUS        0xB0
+
+//! RX STATUS: message in RXB0
+#define MCP2515_RXB0_FULL        0x40
+//! RX STATUS: message in RXB1
+#define MCP2515_RXB1_FULL        0x80
+
+//! number of receive buffers
+#define MCP2515_NUM_OF_RXB       2
+
+//! number of transmit buffers
+#define MCP2515_NUM_OF_TXB       3
+
+// === FUNCTIONS =============================================================
+
+/**
+ * \brief set up receive buffers
+ *
+ * Enables the rollover from RXB0 to RXB1 (BUKT) and the error interrupt to
+ * be informed about receive buffer overflows. The controller needs to be in
+ * configuration mode.
+ *
+ * \param chip controller
+ */
+void mcp2515_rx_setup(eChipSelect chip);
+
+/**
+ * \brief get state of receive buffers (RX STATUS)
+ * \param chip controller
+ * \return MCP2515_RXB0_FULL and/or MCP2515_RXB1_FULL
+ */
+uint8_t mcp2515_rx_status(eChipSelect chip);
+
+/**
+ * \brief read frame from receive buffer (READ RX BUFFER)
+ *
+ * Only the data bytes given by the DLC are transferred. The interrupt flag
+ * of the buffer is cleared automatically.
+ *
+ * \param chip controller
+ * \param buffer 0 or 1
+ * \param msg frame to fill
+ */
+void mcp2515_read_rx_buffer(eChipSelect chip, uint8_t buffer, can_t* msg);
+
+/**
+ * \brief write frame to transmit buffer (LOAD TX BUFFER)
+ *
+ * Id, DLC and the data bytes given by the DLC are written with a single
+ * chip select. The transmission needs to be requested separately.
+ *
+ * \param chip controller
+ * \param buffer 0..2
+ * \param msg frame to send
+ */
+void mcp2515_load_tx_buffer(eChipSelect chip, uint8_t buffer, const can_t* msg);
+
+/**
+ * \brief read consecutive registers with a single chip select
+ * \param chip controller
+ * \param address of first register
+ * \param data buffer to fill
+ * \param length number of registers
+ */
+void mcp2515_read_burst(eChipSelect chip, uint8_t address, uint8_t* data, uint8_t length);
+
+/**
+ * \brief write consecutive registers with a single chip select
+ * \param chip controller
+ * \param address of first register
+ * \param data values to write
+ * \param length number of registers
+ */
+void mcp2515_write_burst(eChipSelect chip, uint8_t address, const uint8_t* data, uint8_t length);
+
+/**
+ * \brief check for receive buffer overflow
+ *
+ * Reads and clears the error flags, if the error interrupt is set. Any
+ * overflow of RXB0 or RXB1 is counted.
+ *
+ * \param chip controller
+ * \return true, if an error interrupt was handled
+ */
+bool mcp2515_rx_check_overflow(eChipSelect chip);
+
+/**
+ * \brief get number of receive buffer overflows
+ * \param chip controller
+ * \param buffer 0 or 1
+ * \return overflows counted (RX0OVR/RX1OVR of EFLG)
+ */
+uint16_t mcp2515_rx_overflows(eChipSelect chip, uint8_t buffer);
+
+#endif /* MCP2515_BURST_H_ */
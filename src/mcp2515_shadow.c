@@ -0,0 +1,132 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file mcp2515_shadow.c
+ *
+ * \date Created: 16.10.2026 23:15:51
+ * \author agent
+ **/
+
+
+#include <stdbool.h>
+
+#include "hal.h"
+#include "mcp2515_burst.h"
+#include "mcp2515_shadow.h"
+
+// === DEFINITIONS ===========================================================
+
+//! writable bits of RXB0CTRL (RXM1, RXM0, BUKT)
+#define MCP2515_RXB0CTRL_MASK    0x64
+
+//! writable bits of RXB1CTRL (RXM1, RXM0)
+#define MCP2515_RXB1CTRL_MASK    0x60
+
+// === GLOBALS ===============================================================
+
+//! configuration registers per controller
+static uint8_t shadow[NUM_OF_MCP2515][MCP2515_SHADOW_SIZE];
+
+//! receive buffer control per controller
+static uint8_t shadowRxbCtrl[NUM_OF_MCP2515][MCP2515_NUM_OF_RXB];
+
+//! repairs per controller
+static uint16_t repairs[NUM_OF_MCP2515];
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief check for registers not part of the configuration
+ *
+ * CANSTAT and CANCTRL are mapped to the end of each row of the register
+ * table, TEC and REC are error counters.
+ *
+ * \param address of register
+ * \return true, if the register is skipped
+ */
+static bool mcp2515_shadow_skip(uint8_t address)
+{
+   return ((address & 0x0F) >= CANSTAT) || (TEC == address) || (REC == address);
+}
+
+// === FUNCTIONS =============================================================
+
+void mcp2515_shadow_capture(eChipSelect chip)
+{
+   mcp2515_read_burst(chip, MCP2515_SHADOW_FIRST, shadow[chip], MCP2515_SHADOW_SIZE);
+   shadowRxbCtrl[chip][0] = read_register_mcp2515(chip, RXB0CTRL) & MCP2515_RXB0CTRL_MASK;
+   shadowRxbCtrl[chip][1] = read_register_mcp2515(chip, RXB1CTRL) & MCP2515_RXB1CTRL_MASK;
+}
+
+uint8_t mcp2515_shadow_verify(eChipSelect chip, eCanMode mode)
+{
+   uint8_t current[MCP2515_SHADOW_SIZE];
+   uint8_t written = 0;
+   uint8_t first;
+   uint8_t i;
+
+   mcp2515_read_burst(chip, MCP2515_SHADOW_FIRST, current, MCP2515_SHADOW_SIZE);
+
+   for(i = 0; i < MCP2515_SHADOW_SIZE; ++i)
+   {
+      if(!mcp2515_shadow_skip(MCP2515_SHADOW_FIRST + i) && (current[i] != shadow[chip][i]))
+      {
+         break;
+      }
+   }
+   if(MCP2515_SHADOW_SIZE == i)
+   {
+      // fast path: configuration is intact
+      return 0;
+   }
+
+   set_mode_mcp2515(chip, CONFIG_MODE);
+
+   // write each run of differing registers with a single burst
+   while(i < MCP2515_SHADOW_SIZE)
+   {
+      first = i;
+      while((i < MCP2515_SHADOW_SIZE) &&
+            !mcp2515_shadow_skip(MCP2515_SHADOW_FIRST + i) &&
+            (current[i] != shadow[chip][i]))
+      {
+         ++i;
+      }
+      if(i > first)
+      {
+         mcp2515_write_burst(chip, MCP2515_SHADOW_FIRST + first, &shadow[chip][first], i - first);
+         written += i - first;
+      }
+      else
+      {
+         ++i;
+      }
+   }
+
+   // receive buffer control is not covered by the burst, but lost likewise
+   bit_modify_mcp2515(chip, RXB0CTRL, MCP2515_RXB0CTRL_MASK, shadowRxbCtrl[chip][0]);
+   bit_modify_mcp2515(chip, RXB1CTRL, MCP2515_RXB1CTRL_MASK, shadowRxbCtrl[chip][1]);
+
+   set_mode_mcp2515(chip, mode);
+
+   if(UINT16_MAX != repairs[chip])
+   {
+      ++repairs[chip];
+   }
+   return written;
+}
+
+uint16_t mcp2515_shadow_repairs(eChipSelect chip)
+{
+   return repairs[chip];
+}
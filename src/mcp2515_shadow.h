@@ -0,0 +1,75 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file mcp2515_shadow.h
+ *
+ * Copy of the configuration registers of the MCP2515 (filters, masks, bit
+ * timing, interrupt enable and receive buffer control). It is taken once
+ * after initCAN() and checked on each wake up, since the controller may
+ * lose its configuration, e.g. by undervoltage while cranking.
+ *
+ * The check reads RXF0SIDH..CANINTE in a single burst. Only registers
+ * differing from the copy are written again, so an intact controller costs
+ * one burst of 46 bytes instead of the whole initialization.
+ *
+ * \date Created: 16.10.2026 23:15:51
+ * \author agent
+ **/
+
+
+#ifndef MCP2515_SHADOW_H_
+#define MCP2515_SHADOW_H_
+
+#include <stdint.h>
+
+#include "can/can_mcp2515.h"
+
+// === DEFINITIONS ===========================================================
+
+//! first register of the copy
+#define MCP2515_SHADOW_FIRST     RXF0SIDH
+
+//! number of registers of the copy (RXF0SIDH..CANINTE)
+#define MCP2515_SHADOW_SIZE      (CANINTE - RXF0SIDH + 1)
+
+// === FUNCTIONS =============================================================
+
+/**
+ * \brief take a copy of the configuration
+ *
+ * Called after the controller is set up completely.
+ *
+ * \param chip controller
+ */
+void mcp2515_shadow_capture(eChipSelect chip);
+
+/**
+ * \brief check configuration and write the registers differing
+ *
+ * If anything differs, the controller is set to configuration mode for
+ * writing and to the given mode afterwards.
+ *
+ * \param chip controller
+ * \param mode to set after writing
+ * \return number of registers written again
+ */
+uint8_t mcp2515_shadow_verify(eChipSelect chip, eCanMode mode);
+
+/**
+ * \brief get number of repairs
+ * \param chip controller
+ * \return checks which needed to write registers (saturating)
+ */
+uint16_t mcp2515_shadow_repairs(eChipSelect chip);
+
+#endif /* MCP2515_SHADOW_H_ */
@@ -0,0 +1,218 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file pdc_decode.c
+ *
+ * \date Created: 16.10.2026 22:50:54
+ * \author agent
+ **/
+
+
+#include "hal.h"
+#include "pdc_decode.h"
+#include "PDCViewer.h"
+
+// === TABLES ================================================================
+
+/**
+ * \brief signals of all messages
+ *
+ * Signals of one message need to be in a row. See PDC_CAN_ID for the layout
+ * of the current message. By default only the rear sensors are used: left
+ * is the nearest of rear left and rear mid left, right likewise. See
+ * NUM_OF_PDC_SENSORS for the slots of all sensors.
+ */
+static const pdc_signal_t pdcSignals[] PROGMEM =
+{
+   // PDC_CAN_ID
+   //byte shift length mul  shift slot
+#ifdef PDC_ALL_SENSORS
+   {  0,   0,    8,     1,   0,    0 },  // front left
+   {  4,   0,    8,     1,   0,    1 },  // front mid left
+   {  5,   0,    8,     1,   0,    2 },  // front mid right
+   {  1,   0,    8,     1,   0,    3 },  // front right
+   {  2,   0,    8,     1,   0,    4 },  // rear left
+   {  6,   0,    8,     1,   0,    5 },  // rear mid left
+   {  7,   0,    8,     1,   0,    6 },  // rear mid right
+   {  3,   0,    8,     1,   0,    7 }   // rear right
+#else
+   {  2,   0,    8,     1,   0,    0 },  // rear left
+   {  6,   0,    8,     1,   0,    0 },  // rear mid left
+   {  3,   0,    8,     1,   0,    1 },  // rear right
+   {  7,   0,    8,     1,   0,    1 }   // rear mid right
+#endif
+};
+
+//! number of signals of PDC_CAN_ID
+#define PDC_NUM_OF_SIGNALS       (sizeof(pdcSignals) / sizeof(pdcSignals[0]))
+
+/**
+ * \brief all messages decoded
+ *
+ * The table needs to be sorted by CAN id for the binary search.
+ */
+static const pdc_message_t pdcMessages[] PROGMEM =
+{
+   //canId       first count
+   { PDC_CAN_ID, 0,    PDC_NUM_OF_SIGNALS }
+};
+
+//! number of messages
+#define PDC_NUM_OF_MESSAGES      (sizeof(pdcMessages) / sizeof(pdcMessages[0]))
+
+// === GLOBALS ===============================================================
+
+//! id the message PDC_CAN_ID is received with, see pdc_decode_set_id()
+static uint16_t pdcCanId = PDC_CAN_ID;
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief get id of a message of the table
+ * \param index of message
+ * \return id, PDC_CAN_ID replaced by the one set
+ */
+static uint16_t pdc_table_id(uint8_t index)
+{
+   uint16_t id = pgm_read_word(&pdcMessages[index].canId);
+
+   return (PDC_CAN_ID == id) ? pdcCanId : id;
+}
+
+/**
+ * \brief find message description by binary search
+ * \param canId to search for
+ * \param desc description to fill
+ * \return true, if found
+ */
+static bool pdc_find_message(uint16_t canId, pdc_message_t* desc)
+{
+   uint8_t  low  = 0;
+   uint8_t  high = PDC_NUM_OF_MESSAGES;
+   uint8_t  mid;
+   uint16_t id;
+
+   while(low < high)
+   {
+      mid = (uint8_t)((low + high) >> 1);
+      id  = pdc_table_id(mid);
+
+      if(id == canId)
+      {
+         memcpy_P(desc, &pdcMessages[mid], sizeof(*desc));
+         return true;
+      }
+      else if(id < canId)
+      {
+         low = mid + 1;
+      }
+      else
+      {
+         high = mid;
+      }
+   }
+   return false;
+}
+
+/**
+ * \brief get id of a message
+ * \param index of message
+ * \return 11bit id
+ */
+static uint16_t pdc_message_id(uint8_t index)
+{
+   return pdc_table_id(index) & PDC_ID_MASK_EXACT;
+}
+
+// === FUNCTIONS =============================================================
+
+uint8_t pdc_decode(const can_t* msg, uint8_t* values)
+{
+   pdc_message_t desc;
+   pdc_signal_t  sig;
+   uint8_t       touched = 0;
+   uint8_t       raw;
+   uint8_t       max;
+   uint8_t       value;
+   uint16_t      scaled;
+   uint8_t       i;
+
+   if((msg->msgId > PDC_ID_MASK_EXACT) || !pdc_find_message((uint16_t)msg->msgId, &desc))
+   {
+      return 0;
+   }
+
+   for(i = desc.first; i < (uint8_t)(desc.first + desc.count); ++i)
+   {
+      memcpy_P(&sig, &pdcSignals[i], sizeof(sig));
+
+      if((sig.byte >= msg->header.len) || (sig.slot >= NUM_OF_PDC_SENSORS))
+      {
+         continue;
+      }
+
+      max = (uint8_t)(0xFF >> (8 - sig.length));
+      raw = (msg->data[sig.byte] >> sig.shift) & max;
+
+      if(raw == max)
+      {
+         value = PDC_OUT_OF_RANGE;
+      }
+      else
+      {
+         scaled = (uint16_t)(((uint16_t)raw * sig.scaleMul) >> sig.scaleShift);
+         value  = (scaled < PDC_OUT_OF_RANGE) ? (uint8_t)scaled : (PDC_OUT_OF_RANGE - 1);
+      }
+
+      // first signal of the slot sets it, the others take the nearest
+      if((0 == (touched & (1 << sig.slot))) || (value < values[sig.slot]))
+      {
+         values[sig.slot] = value;
+      }
+      touched |= (uint8_t)(1 << sig.slot);
+   }
+
+   return touched;
+}
+
+void pdc_decode_set_id(uint16_t canId)
+{
+   pdcCanId = canId & PDC_ID_MASK_EXACT;
+}
+
+uint16_t pdc_decode_mask(void)
+{
+   uint16_t differ = 0;
+   uint8_t  i;
+
+   if(PDC_NUM_OF_MESSAGES <= PDC_NUM_OF_FILTERS)
+   {
+      return PDC_ID_MASK_EXACT;
+   }
+
+   for(i = 1; i < PDC_NUM_OF_MESSAGES; ++i)
+   {
+      differ |= pdc_message_id(i) ^ pdc_message_id(0);
+   }
+   return (uint16_t)(~differ & PDC_ID_MASK_EXACT);
+}
+
+uint16_t pdc_decode_filter(uint8_t filter)
+{
+   // unused filters repeat the last id
+   if(filter >= PDC_NUM_OF_MESSAGES)
+   {
+      filter = PDC_NUM_OF_MESSAGES - 1;
+   }
+   return pdc_message_id(filter);
+}
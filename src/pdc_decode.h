@@ -0,0 +1,129 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file pdc_decode.h
+ *
+ * Table driven decoder of the PDC messages. The messages and signals are
+ * described by constant tables in flash. Supporting another vehicle means
+ * changing the tables in pdc_decode.c only. The acceptance masks and
+ * filters of the MCP2515 are derived from the same tables.
+ *
+ * \date Created: 16.10.2026 22:50:54
+ * \author agent
+ **/
+
+
+#ifndef PDC_DECODE_H_
+#define PDC_DECODE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "can/can_mcp2515.h"
+
+// === DEFINITIONS ===========================================================
+
+//! number of acceptance filters of the MCP2515 (RXF0..RXF5)
+#define PDC_NUM_OF_FILTERS       6
+
+//! filters in consecutive registers (RXF0..RXF2 and RXF3..RXF5)
+#define PDC_FILTERS_PER_ROW      3
+
+//! mask matching all bits of a standard id
+#define PDC_ID_MASK_EXACT        0x7FF
+
+// === TYPE DEFINITIONS ======================================================
+
+/**
+ * \brief description of a signal within a message
+ *
+ * The raw value is taken from byte \c byte starting at bit \c shift with
+ * \c length bits. The maximum raw value means "nothing in range". Any other
+ * raw value is scaled: value = (raw * scaleMul) >> scaleShift
+ *
+ * All signals of a message targeting the same slot are combined by taking
+ * the minimum (nearest object).
+ */
+typedef struct
+{
+   //! byte offset within the message
+   uint8_t  byte;
+   //! bit position of the LSB within the byte
+   uint8_t  shift;
+   //! number of bits (1..8)
+   uint8_t  length;
+   //! scaling factor
+   uint8_t  scaleMul;
+   //! scaling shift (divisor 2^n)
+   uint8_t  scaleShift;
+   //! sensor slot the value is stored in
+   uint8_t  slot;
+} pdc_signal_t;
+
+/**
+ * \brief description of a message
+ */
+typedef struct
+{
+   //! CAN id (11bit)
+   uint16_t canId;
+   //! index of first signal in signal table
+   uint8_t  first;
+   //! number of signals
+   uint8_t  count;
+} pdc_message_t;
+
+// === FUNCTIONS =============================================================
+
+/**
+ * \brief decode a message into the sensor slots
+ *
+ * The message is searched by binary search in the message table, so the
+ * cost grows only logarithmically with the number of messages.
+ *
+ * \param msg received frame
+ * \param values sensor slots to update
+ * \return bit mask of the slots updated, 0 if the message isn't described
+ *         by the table
+ */
+uint8_t pdc_decode(const can_t* msg, uint8_t* values);
+
+/**
+ * \brief set id of the PDC message
+ *
+ * Replaces PDC_CAN_ID of the message table. With more messages in the
+ * table, the id needs to keep it sorted. Set before the filters.
+ *
+ * \param canId 11bit id
+ */
+void pdc_decode_set_id(uint16_t canId);
+
+/**
+ * \brief get acceptance mask of the receive buffers
+ *
+ * If all ids fit into the filters, the mask matches the id exactly.
+ * Otherwise only the bits all ids have in common are checked and the
+ * decoder sorts out the rest.
+ *
+ * \return 11bit mask
+ */
+uint16_t pdc_decode_mask(void);
+
+/**
+ * \brief get acceptance filter
+ * \param filter number 0..PDC_NUM_OF_FILTERS-1 (RXF0..RXF5)
+ * \return 11bit id
+ */
+uint16_t pdc_decode_filter(uint8_t filter);
+
+#endif /* PDC_DECODE_H_ */
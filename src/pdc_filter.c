@@ -0,0 +1,171 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file pdc_filter.c
+ *
+ * \date Created: 16.10.2026 23:30:47
+ * \author agent
+ **/
+
+
+#include "hal.h"
+#include "PDCViewer.h"
+#include "pdc_filter.h"
+
+// === DEFINITIONS ===========================================================
+
+/**
+ * \brief state of a sensor
+ */
+typedef struct
+{
+   //! last two values decoded, newest first
+   uint8_t  history[2];
+   //! average with PDC_FILTER_EMA_FRACTION bits of fraction
+   uint16_t average;
+   //! last value filtered
+   uint8_t  value;
+} pdc_filter_state_t;
+
+//! half of the least significant bit of the value in the average
+#define PDC_FILTER_EMA_HALF      (1 << (PDC_FILTER_EMA_FRACTION - 1))
+
+// === GLOBALS ===============================================================
+
+//! stages selected
+static uint8_t filterMode = PDC_FILTER_DEFAULT;
+
+//! sensors with history, bit per slot
+static uint8_t primed = 0;
+
+//! state of all sensors
+static pdc_filter_state_t sensors[NUM_OF_PDC_SENSORS];
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief median of three values
+ * \param a value
+ * \param b value
+ * \param c value
+ * \return median
+ */
+static uint8_t pdc_filter_median(uint8_t a, uint8_t b, uint8_t c)
+{
+   uint8_t swap;
+
+   if(a > b)
+   {
+      swap = a;
+      a    = b;
+      b    = swap;
+   }
+   // a <= b: median is max(a, min(b, c))
+   if(c <= a)
+   {
+      return a;
+   }
+   return (c < b) ? c : b;
+}
+
+/**
+ * \brief filter a value of a sensor
+ * \param sensor state
+ * \param raw value decoded
+ * \return value to show
+ */
+static uint8_t pdc_filter_sensor(pdc_filter_state_t* sensor, uint8_t raw)
+{
+   uint8_t  value = raw;
+   uint16_t target;
+
+   if(filterMode & PDC_FILTER_MEDIAN)
+   {
+      value              = pdc_filter_median(raw, sensor->history[0], sensor->history[1]);
+      sensor->history[1] = sensor->history[0];
+      sensor->history[0] = raw;
+   }
+
+   if(filterMode & PDC_FILTER_EMA)
+   {
+      target = (uint16_t)value << PDC_FILTER_EMA_FRACTION;
+      if((PDC_OUT_OF_RANGE == value) || (PDC_OUT_OF_RANGE == sensor->value))
+      {
+         sensor->average = target;
+      }
+      else if(target > sensor->average)
+      {
+         sensor->average += (uint16_t)((target - sensor->average) >> PDC_FILTER_EMA_SHIFT);
+      }
+      else
+      {
+         sensor->average -= (uint16_t)((sensor->average - target) >> PDC_FILTER_EMA_SHIFT);
+      }
+      value = (uint8_t)((sensor->average + PDC_FILTER_EMA_HALF) >> PDC_FILTER_EMA_FRACTION);
+   }
+
+   if((filterMode & PDC_FILTER_RATE) &&
+      (PDC_OUT_OF_RANGE != value) && (PDC_OUT_OF_RANGE != sensor->value))
+   {
+      if((value > sensor->value) && ((uint8_t)(value - sensor->value) > PDC_FILTER_RATE_STEP))
+      {
+         value = sensor->value + PDC_FILTER_RATE_STEP;
+      }
+      else if((value < sensor->value) && ((uint8_t)(sensor->value - value) > PDC_FILTER_RATE_STEP))
+      {
+         value = sensor->value - PDC_FILTER_RATE_STEP;
+      }
+   }
+
+   sensor->value = value;
+   return value;
+}
+
+// === FUNCTIONS =============================================================
+
+void pdc_filter_set_mode(uint8_t mode)
+{
+   filterMode = mode;
+}
+
+void pdc_filter_reset(uint8_t slots)
+{
+   primed &= (uint8_t)~slots;
+}
+
+void pdc_filter(uint8_t slots, const uint8_t* raw, uint8_t* values)
+{
+   pdc_filter_state_t* sensor = sensors;
+   uint8_t             mask   = 1;
+   uint8_t             i;
+
+   for(i = 0; i < NUM_OF_PDC_SENSORS; ++i, ++sensor, mask <<= 1)
+   {
+      if(0 == (slots & mask))
+      {
+         continue;
+      }
+
+      if(0 == (primed & mask))
+      {
+         // nothing to compare with: the history starts with this value
+         sensor->history[0] = raw[i];
+         sensor->history[1] = raw[i];
+         sensor->average    = (uint16_t)raw[i] << PDC_FILTER_EMA_FRACTION;
+         sensor->value      = raw[i];
+         primed            |= mask;
+      }
+      values[i] = pdc_filter_sensor(sensor, raw[i]);
+      hal_trace_filtered(i, raw[i], values[i]);
+   }
+}
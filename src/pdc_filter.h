@@ -0,0 +1,85 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file pdc_filter.h
+ *
+ * Smoothing of the decoded distances per sensor. The stages selected run
+ * in this order:
+ *
+ * * median of the last three values, rejects a single bad frame
+ * * exponential moving average in fixed point, weight 2^-PDC_FILTER_EMA_SHIFT
+ * * rate limit, the value changes by PDC_FILTER_RATE_STEP per frame at most
+ *
+ * Only compares, adds and shifts are used, no division and no loop
+ * depending on the values, so the cost per sensor is fixed.
+ *
+ * PDC_OUT_OF_RANGE is a state, not a distance: the average and the rate
+ * limit pass changes from and to it at once. The first value of a sensor
+ * after pdc_filter_reset() is passed as well.
+ *
+ * \date Created: 16.10.2026 23:30:47
+ * \author agent
+ **/
+
+
+#ifndef PDC_FILTER_H_
+#define PDC_FILTER_H_
+
+#include <stdint.h>
+
+// === DEFINITIONS ===========================================================
+
+//! no filter, the decoded values are shown
+#define PDC_FILTER_NONE          0x00
+//! median of three
+#define PDC_FILTER_MEDIAN        0x01
+//! exponential moving average
+#define PDC_FILTER_EMA           0x02
+//! rate limit
+#define PDC_FILTER_RATE          0x04
+
+//! stages used without settings
+#define PDC_FILTER_DEFAULT       PDC_FILTER_MEDIAN
+
+//! weight of a new value is 2^-n
+#define PDC_FILTER_EMA_SHIFT     2
+
+//! fraction bits of the average
+#define PDC_FILTER_EMA_FRACTION  4
+
+//! maximum change per frame
+#define PDC_FILTER_RATE_STEP     16
+
+// === FUNCTIONS =============================================================
+
+/**
+ * \brief select stages
+ * \param mode PDC_FILTER_MEDIAN, PDC_FILTER_EMA and/or PDC_FILTER_RATE
+ */
+void pdc_filter_set_mode(uint8_t mode);
+
+/**
+ * \brief forget the history of sensors
+ * \param slots bit mask of the sensor slots
+ */
+void pdc_filter_reset(uint8_t slots);
+
+/**
+ * \brief filter values decoded
+ * \param slots bit mask of the sensor slots decoded (see pdc_decode())
+ * \param raw values decoded
+ * \param values values to show, only the slots given are updated
+ */
+void pdc_filter(uint8_t slots, const uint8_t* raw, uint8_t* values);
+
+#endif /* PDC_FILTER_H_ */
@@ -0,0 +1,144 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file power.c
+ *
+ * \date Created: 16.10.2026 23:10:25
+ * \author agent
+ **/
+
+
+#include <stdbool.h>
+
+#include "hal.h"
+#include "power.h"
+
+#ifdef DEBUG_CHANNEL
+   #include "debug.h"
+#endif
+
+// === GLOBALS ===============================================================
+
+//! counters since power on
+static power_stats_t powerStats;
+
+//! woken up and cause not known yet
+static bool powerAwake = false;
+
+//! frames received since waking up
+static bool powerFrames = false;
+
+#ifdef DEBUG_CHANNEL
+
+//! names of the states, 15 characters each
+static const char stateNames[NUM_OF_STATES][16] PROGMEM =
+{
+   "INIT           ",
+   "RUNNING        ",
+   "SLEEP_DETECTED ",
+   "SLEEPING       ",
+   "WAKEUP         ",
+   "ERROR          "
+};
+
+#endif
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief increment saturating counter
+ * \param counter to increment
+ */
+static void power_count(uint16_t* counter)
+{
+   if(UINT16_MAX != *counter)
+   {
+      ++(*counter);
+   }
+}
+
+// === FUNCTIONS =============================================================
+
+void power_enter(state_t state)
+{
+   if(state < NUM_OF_STATES)
+   {
+      power_count(&powerStats.entries[state]);
+   }
+
+   if(WAKEUP == state)
+   {
+      powerAwake  = true;
+      powerFrames = false;
+   }
+   else if((SLEEP_DETECTED == state) && powerAwake)
+   {
+      power_count(&powerStats.wakeups[powerFrames ? POWER_WAKE_FRAME : POWER_WAKE_SPURIOUS]);
+      powerAwake = false;
+   }
+
+   hal_trace_state(state);
+}
+
+void power_tick(void)
+{
+   if(UINT32_MAX != powerStats.runningTicks)
+   {
+      ++powerStats.runningTicks;
+   }
+}
+
+void power_frame(void)
+{
+   powerFrames = true;
+}
+
+const power_stats_t* power_stats(void)
+{
+   return &powerStats;
+}
+
+#ifdef DEBUG_CHANNEL
+
+bool power_dump_line(uint8_t line)
+{
+   if(0 == line)
+   {
+      debug_puts_P(PSTR("state            entries"));
+   }
+   else if(line <= NUM_OF_STATES)
+   {
+      debug_puts_P(stateNames[line - 1]);
+      debug_put_dec(powerStats.entries[line - 1], 8);
+   }
+   else if((NUM_OF_STATES + 1) == line)
+   {
+      debug_puts_P(PSTR("running ticks  "));
+      debug_put_dec(powerStats.runningTicks, 8);
+   }
+   else if((NUM_OF_STATES + 2) == line)
+   {
+      debug_puts_P(PSTR("wake frame     "));
+      debug_put_dec(powerStats.wakeups[POWER_WAKE_FRAME], 8);
+   }
+   else
+   {
+      debug_puts_P(PSTR("wake spurious  "));
+      debug_put_dec(powerStats.wakeups[POWER_WAKE_SPURIOUS], 8);
+   }
+   debug_newline();
+
+   return (line < (NUM_OF_STATES + 3));
+}
+
+#endif
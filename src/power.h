@@ -0,0 +1,107 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file power.h
+ *
+ * Residency of the FSM states and causes of waking up. The counters are
+ * kept in RAM, which is retained in power down mode, so they sum up all
+ * sleep cycles since power on.
+ *
+ * No clock runs in power down mode, so the AVR measures the time spent
+ * RUNNING only (in refreshes of the display). The host build measures all
+ * states in virtual time, see host/energy.h.
+ *
+ * \date Created: 16.10.2026 23:10:25
+ * \author agent
+ **/
+
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include <stdint.h>
+
+#include "PDCViewer.h"
+
+// === TYPE DEFINITIONS ======================================================
+
+/**
+ * \brief causes of waking up
+ *
+ * The frame waking up the MCP2515 is lost, so the cause is known when the
+ * bus becomes silent again.
+ */
+typedef enum
+{
+   //! frames were accepted by the filters after waking up
+   POWER_WAKE_FRAME           = 0,
+   //! no frame accepted until sleeping again (unrelated traffic)
+   POWER_WAKE_SPURIOUS        = 1,
+   //! always the last one
+   POWER_NUM_OF_WAKE_CAUSES   = 2
+} ePowerWake;
+
+/**
+ * \brief counters of the power states
+ *
+ * All counters saturate.
+ */
+typedef struct
+{
+   //! number of times each state was entered
+   uint16_t entries[NUM_OF_STATES];
+   //! refreshes of the display (~10.75ms each) in state RUNNING
+   uint32_t runningTicks;
+   //! wake ups by cause
+   uint16_t wakeups[POWER_NUM_OF_WAKE_CAUSES];
+} power_stats_t;
+
+// === FUNCTIONS =============================================================
+
+/**
+ * \brief count entering a state of the FSM
+ *
+ * Called by the main loop after the state changed.
+ *
+ * \param state entered
+ */
+void power_enter(state_t state);
+
+/**
+ * \brief count a refresh of the display while RUNNING
+ */
+void power_tick(void);
+
+/**
+ * \brief note frames received since waking up
+ */
+void power_frame(void);
+
+/**
+ * \brief get counters
+ * \return pointer to counters
+ */
+const power_stats_t* power_stats(void);
+
+#ifdef DEBUG_CHANNEL
+
+/**
+ * \brief dump a line of the counters via debug channel
+ * \param line 0 for the first one
+ * \return true, if more lines follow
+ */
+bool power_dump_line(uint8_t line);
+
+#endif
+
+#endif /* POWER_H_ */
@@ -0,0 +1,266 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file profiler.c
+ *
+ * \date Created: 16.10.2026 22:53:03
+ * \author agent
+ **/
+
+
+#include <string.h>
+
+#include "hal.h"
+#include "debug.h"
+#include "power.h"
+#include "profiler.h"
+#include "systick.h"
+#include "telemetry.h"
+
+#ifdef PROFILING
+
+// === TYPE DEFINITIONS ======================================================
+
+/**
+ * \brief statistics of a probe
+ */
+typedef struct
+{
+   //! number of measurements
+   uint32_t count;
+   //! minimum duration
+   uint16_t min;
+   //! maximum duration
+   uint16_t max;
+   //! sum of all durations (mean = sum / count)
+   uint32_t sum;
+   //! histogram (saturating)
+   uint16_t hist[PROFILER_NUM_OF_BUCKETS];
+} probe_t;
+
+// === GLOBALS ===============================================================
+
+//! statistics of all probes
+static probe_t probes[NUM_OF_PROBES];
+
+//! cycles elapsed since init, up to the last poll
+static uint32_t elapsed = 0;
+
+//! cycle counter at last poll
+static uint16_t lastPoll = 0;
+
+//! elapsed cycles each probe started over at
+static uint32_t probeSince[NUM_OF_PROBES];
+
+//! CPU budget of the ISRs dumped so far (ms/s)
+static uint32_t isrLoad = 0;
+
+//! names of the probes
+static const char probeNames[NUM_OF_PROBES][PROFILER_NAME_SIZE] PROGMEM =
+{
+   PROFILER_PROBE_NAMES
+};
+
+#ifdef TELEMETRY
+//! start of the period streamed
+static uint16_t sampleStart = 0;
+
+//! probe streamed next
+static uint8_t sampleNext = NUM_OF_PROBES;
+#endif
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief take a consistent copy of a probe and start over
+ * \param probe to take
+ * \param p copy
+ * \return cycles elapsed since the probe started over last
+ */
+static uint32_t profiler_take(uint8_t probe, probe_t* p)
+{
+   uint32_t now = elapsed + (uint16_t)(hal_cycles() - lastPoll);
+   uint32_t since;
+   uint8_t  state;
+
+   state = hal_irq_save();
+   *p = probes[probe];
+   memset(&probes[probe], 0, sizeof(probes[probe]));
+   probes[probe].min = UINT16_MAX;
+   hal_irq_restore(state);
+
+   since             = probeSince[probe];
+   probeSince[probe] = now;
+   return now - since;
+}
+
+#ifdef TELEMETRY
+/**
+ * \brief stream the next probe via telemetry and start it over
+ *
+ * One probe per poll, so the records don't overflow the ring at once.
+ */
+static void profiler_sample(void)
+{
+   probe_t p;
+
+   (void)profiler_take(sampleNext, &p);
+   if(0 != p.count)
+   {
+      telemetry_profile(sampleNext, p.count, p.min, p.max, p.sum);
+   }
+   ++sampleNext;
+}
+#endif
+
+// === FUNCTIONS =============================================================
+
+void profiler_init(void)
+{
+   uint8_t i;
+
+   for(i = 0; i < NUM_OF_PROBES; ++i)
+   {
+      probes[i].min = UINT16_MAX;
+   }
+   hal_cycles_init();
+   debug_init();
+   lastPoll = hal_cycles();
+#ifdef TELEMETRY
+   sampleStart = systick_now();
+#endif
+}
+
+void profiler_record(eProbe probe, uint16_t duration)
+{
+   probe_t* p      = &probes[probe];
+   uint16_t limit  = 16;
+   uint8_t  bucket = 0;
+   uint8_t  state;
+
+   // probes of ISRs may interrupt the ones of the main loop
+   state = hal_irq_save();
+
+   if(UINT32_MAX != p->count)
+   {
+      ++p->count;
+      p->sum += duration;
+   }
+   if(duration < p->min)
+   {
+      p->min = duration;
+   }
+   if(duration > p->max)
+   {
+      p->max = duration;
+   }
+
+   // no division: find bucket by doubling the limit
+   while((bucket < (PROFILER_NUM_OF_BUCKETS - 1)) && (duration >= limit))
+   {
+      limit <<= 1;
+      ++bucket;
+   }
+   if(UINT16_MAX != p->hist[bucket])
+   {
+      ++p->hist[bucket];
+   }
+
+   hal_irq_restore(state);
+}
+
+void profiler_poll(void)
+{
+   uint16_t now = hal_cycles();
+
+   // polled often enough to not miss a wrap around of the counter
+   elapsed += (uint16_t)(now - lastPoll);
+   lastPoll = now;
+
+#ifdef TELEMETRY
+   if(systick_since(sampleStart) >= TELEMETRY_PERIOD)
+   {
+      sampleStart += TELEMETRY_PERIOD;
+      sampleNext   = 0;
+   }
+   if(sampleNext < NUM_OF_PROBES)
+   {
+      profiler_sample();
+   }
+#endif
+}
+
+bool profiler_dump_line(uint8_t line)
+{
+   probe_t  p;
+   uint32_t perMille;
+   uint8_t  i;
+
+   if(0 == line)
+   {
+      debug_puts_P(PSTR("probe              count   min   max  mean  ms/s |   <16   <32   <64  <128  <256  <512   <1k  >=1k"));
+      debug_newline();
+      isrLoad = 0;
+      return true;
+   }
+
+   if(line <= NUM_OF_PROBES)
+   {
+      i        = line - 1;
+      perMille = profiler_take(i, &p) / 1000;
+
+      debug_puts_P(probeNames[i]);
+      debug_put_dec(p.count, 10);
+      debug_put_dec((0 != p.count) ? p.min : 0, 6);
+      debug_put_dec(p.max, 6);
+      debug_put_dec((0 != p.count) ? (p.sum / p.count) : 0, 6);
+      // share of the elapsed time, no division by zero after a short run
+      debug_put_dec((0 != perMille) ? (p.sum / perMille) : 0, 6);
+      debug_puts_P(PSTR(" |"));
+      for(i = 0; i < PROFILER_NUM_OF_BUCKETS; ++i)
+      {
+         debug_put_dec(p.hist[i], 6);
+      }
+      debug_newline();
+
+      if(line > PROF_ISR_TIMER1)
+      {
+         isrLoad += (0 != perMille) ? (p.sum / perMille) : 0;
+      }
+      return true;
+   }
+
+   if((NUM_OF_PROBES + 1) == line)
+   {
+      // CPU budget of all ISRs
+      debug_puts_P(PSTR("ISR total                                 "));
+      debug_put_dec(isrLoad, 6);
+      debug_puts_P(PSTR(" ms/s"));
+      debug_newline();
+      return true;
+   }
+
+   // residency of the states, kept over all dumps
+   return power_dump_line(line - (NUM_OF_PROBES + 2));
+}
+
+void profiler_dump(void)
+{
+   uint8_t line = 0;
+
+   while(profiler_dump_line(line++))
+   {
+   }
+}
+
+#endif
@@ -0,0 +1,167 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file profiler.h
+ *
+ * Hot path profiler. Each probe samples the free running cycle counter of
+ * the HAL at entry and exit and keeps count, min, max, sum and a histogram
+ * of the durations. The table is dumped via the debug channel on request.
+ *
+ * Only active, if PROFILING is defined (cmake -DWITH_PROFILING=ON).
+ * Otherwise all macros are empty.
+ *
+ * Durations are measured in CPU cycles on the AVR (including the Timer0
+ * overflow interrupt and any nested ISR) and virtual cycles on the host,
+ * where only SPI, EEPROM and UART accesses take time.
+ *
+ * The dump shows the CPU budget of each probe as time per second (ms/s)
+ * and the sum of all ISRs. Statistics start over after each dump. The
+ * dump is sent one line per tick by debug_poll(), so each probe counts
+ * the cycles elapsed since its own line was sent last.
+ *
+ * With TELEMETRY the statistics of each probe are streamed and start over
+ * each TELEMETRY_PERIOD instead (see telemetry.h).
+ *
+ * \date Created: 16.10.2026 22:53:03
+ * \author agent
+ **/
+
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * \brief all probes
+ */
+typedef enum
+{
+   //! run()
+   PROF_RUN             = 0,
+   //! sleepDetected() without saving the settings (see config_save())
+   PROF_SLEEP_DETECTED  = 1,
+   //! wakeUp()
+   PROF_WAKEUP          = 2,
+   //! framebuffer update
+   PROF_MATRIXBAR       = 3,
+   //! loading the settings on boot
+   PROF_CONFIG          = 4,
+   //! filtering the values of a frame
+   PROF_FILTER          = 5,
+   //! encoding a telemetry record
+   PROF_TELEMETRY       = 6,
+   //! ISR(TIMER1_CAPT_vect), the first ISR
+   PROF_ISR_TIMER1      = 7,
+   //! ISR(TIMER2_COMP_vect)
+   PROF_ISR_TIMER2      = 8,
+   //! ISR(INT0_vect)
+   PROF_ISR_INT0        = 9,
+   //! ISR(USART_UDRE_vect), one byte of telemetry or text each
+   PROF_ISR_UART        = 10,
+   //! always the last one
+   NUM_OF_PROBES        = 11
+} eProbe;
+
+/**
+ * \brief names of the probes (padded to the same length)
+ *
+ * Shared with the decoder of the telemetry on the host.
+ */
+#define PROFILER_PROBE_NAMES     \
+   "run           ",             \
+   "sleepDetected ",             \
+   "wakeUp        ",             \
+   "display       ",             \
+   "config        ",             \
+   "filter        ",             \
+   "telemetry     ",             \
+   "ISR TIMER1    ",             \
+   "ISR TIMER2    ",             \
+   "ISR INT0      ",             \
+   "ISR UART      "
+
+//! size of a name including the terminating zero
+#define PROFILER_NAME_SIZE       15
+
+/**
+ * \brief number of histogram buckets
+ *
+ * Bucket 0 counts durations < 16, each following bucket doubles the limit.
+ * The last bucket counts everything above.
+ */
+#define PROFILER_NUM_OF_BUCKETS  8
+
+#ifdef PROFILING
+
+/**
+ * \brief start measurement of a probe
+ * \param probe to measure
+ */
+#define PROFILE_BEGIN(probe)     uint16_t profStart_##probe = hal_cycles()
+
+/**
+ * \brief end measurement of a probe started in the same block
+ * \param probe to measure
+ */
+#define PROFILE_END(probe)       profiler_record(probe, (uint16_t)(hal_cycles() - profStart_##probe))
+
+/**
+ * \brief initialize profiler and its cycle counter
+ */
+void profiler_init(void);
+
+/**
+ * \brief record a duration
+ * \param probe measured
+ * \param duration measured
+ */
+void profiler_record(eProbe probe, uint16_t duration);
+
+/**
+ * \brief stream the table each period via telemetry
+ *
+ * Also accounts the elapsed time, so it needs to be called at least once
+ * per 65536 cycles (16ms) while running.
+ */
+void profiler_poll(void);
+
+/**
+ * \brief dump a line of the table via debug channel, followed by the
+ *        residency of the states (see power_dump_line())
+ *
+ * The probe of the line starts over.
+ *
+ * \param line 0 for the first one
+ * \return true, if more lines follow
+ */
+bool profiler_dump_line(uint8_t line);
+
+/**
+ * \brief dump table via debug channel at once and start over
+ */
+void profiler_dump(void);
+
+#else
+
+#define PROFILE_BEGIN(probe)
+#define PROFILE_END(probe)
+#define profiler_init()
+#define profiler_poll()
+#define profiler_dump_line(line)       ((void)(line), false)
+#define profiler_dump()
+
+#endif
+
+#endif /* PROFILER_H_ */
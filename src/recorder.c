@@ -0,0 +1,165 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file recorder.c
+ *
+ * \date Created: 16.10.2026 23:56:07
+ * \author agent
+ **/
+
+
+#include "hal.h"
+#include "systick.h"
+#include "config_store.h"
+#include "recorder.h"
+
+#ifdef RECORDER
+
+// === DEFINITIONS ===========================================================
+
+//! index mask
+#define RECORDER_MASK            (RECORDER_SIZE - 1)
+
+//! the image starts behind the settings
+typedef char recorder_addr_check[(RECORDER_ADDR >= CONFIG_STORE_ADDR + CONFIG_STORE_SIZE) ? 1 : -1];
+
+//! the image fits into the EEPROM
+typedef char recorder_image_check[(RECORDER_ADDR + RECORDER_IMAGE_SIZE <= E2END + 1) ? 1 : -1];
+
+// === TYPE DEFINITIONS ======================================================
+
+/**
+ * \brief entry of the ring
+ */
+typedef struct
+{
+   //! event, see eRecorderEvent
+   uint8_t  event;
+   //! times recorded in a row (saturating)
+   uint8_t  count;
+   //! value of the event
+   uint16_t value;
+   //! time of the last one recorded (see systick.h)
+   uint16_t time;
+} recorder_entry_t;
+
+// === GLOBALS ===============================================================
+
+//! events recorded
+static recorder_entry_t entries[RECORDER_SIZE];
+
+//! index of the newest entry
+static uint8_t newest = RECORDER_MASK;
+
+//! entries used
+static uint8_t used = 0;
+
+//! no more events are recorded, the ring is saved
+static volatile bool frozen = false;
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief write a byte of the image
+ * \param addr of the byte, incremented
+ * \param crc so far, updated
+ * \param value to write
+ */
+static void recorder_write(uint16_t* addr, uint16_t* crc, uint8_t value)
+{
+   hal_eeprom_write((*addr)++, value);
+   *crc = hal_crc_ccitt_update(*crc, value);
+}
+
+/**
+ * \brief write a 16bit value of the image (little endian)
+ * \param addr of the value, incremented
+ * \param crc so far, updated
+ * \param value to write
+ */
+static void recorder_write16(uint16_t* addr, uint16_t* crc, uint16_t value)
+{
+   recorder_write(addr, crc, (uint8_t)value);
+   recorder_write(addr, crc, (uint8_t)(value >> 8));
+}
+
+// === FUNCTIONS =============================================================
+
+void recorder_event(eRecorderEvent event, uint16_t value)
+{
+   recorder_entry_t* e;
+   uint8_t           state = hal_irq_save();
+
+   if(!frozen)
+   {
+      e = &entries[newest];
+      if((0 != used) && (event == e->event) && (value == e->value) && (UINT8_MAX != e->count))
+      {
+         ++e->count;
+      }
+      else
+      {
+         newest   = (newest + 1) & RECORDER_MASK;
+         e        = &entries[newest];
+         e->event = (uint8_t)event;
+         e->count = 1;
+         e->value = value;
+         if(used < RECORDER_SIZE)
+         {
+            ++used;
+         }
+      }
+      e->time = systick_now();
+   }
+
+   hal_irq_restore(state);
+}
+
+void recorder_save(uint8_t state)
+{
+   const recorder_entry_t* e;
+   uint16_t                addr = RECORDER_ADDR;
+   uint16_t                crc  = RECORDER_CRC_INIT;
+   uint16_t                now;
+   uint8_t                 i;
+
+   if(frozen)
+   {
+      return;
+   }
+   recorder_event(RECORDER_ERROR, state);
+   // the ISRs keep running while writing
+   frozen = true;
+   // writing takes a while
+   now    = systick_now();
+
+   recorder_write(&addr, &crc, RECORDER_VERSION);
+   recorder_write(&addr, &crc, used);
+   recorder_write16(&addr, &crc, now);
+
+   // oldest first
+   for(i = 0; i < used; ++i)
+   {
+      e = &entries[(uint8_t)(newest + 1 - used + i) & RECORDER_MASK];
+      recorder_write(&addr, &crc, e->event);
+      recorder_write(&addr, &crc, e->count);
+      recorder_write16(&addr, &crc, e->value);
+      recorder_write16(&addr, &crc, e->time);
+   }
+
+   // the CRC itself is not part of it
+   hal_eeprom_write(addr++, (uint8_t)crc);
+   hal_eeprom_write(addr, (uint8_t)(crc >> 8));
+}
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file recorder.h
+ *
+ * Flight recorder: the last RECORDER_SIZE events of the FSM and the ISRs
+ * are kept in a ring in RAM, each with the time of systick.h. Entering the
+ * error state saves the ring to the EEPROM behind the settings once, so the
+ * history of a unit misbehaving can be read out later (see
+ * host/timeline_tool.c).
+ *
+ * An event repeating the one before (same event and value) only counts up
+ * and takes the new time, so the ticks of the display don't push the rest
+ * out of the ring. Recording costs a call and some cycles with interrupts
+ * disabled, it is frozen while saving.
+ *
+ * The EEPROM image holds version, number of entries, time of saving, the
+ * entries from the oldest to the newest and a CRC, all little endian.
+ *
+ * Only active, if RECORDER is defined (cmake -DWITH_RECORDER=ON).
+ * Otherwise all macros are empty.
+ *
+ * \date Created: 16.10.2026 23:56:07
+ * \author agent
+ **/
+
+
+#ifndef RECORDER_H_
+#define RECORDER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// === DEFINITIONS ===========================================================
+
+//! version of the image, increment on any change of the layout
+#define RECORDER_VERSION         1
+
+/**
+ * \brief number of entries kept
+ *
+ * Needs to be 2^n. Each entry takes RECORDER_ENTRY_SIZE bytes of RAM and
+ * EEPROM.
+ */
+#define RECORDER_SIZE            32
+
+//! bytes of an entry (event, count, value, time)
+#define RECORDER_ENTRY_SIZE      6
+
+/**
+ * \brief EEPROM address of the image, behind the settings
+ *
+ * Fixed, so images of the AVR and the host match and the settings may grow
+ * (see CONFIG_STORE_SIZE) without moving it.
+ */
+#define RECORDER_ADDR            0x100
+
+//! bytes of the header (version, number of entries, time of saving)
+#define RECORDER_HEADER_SIZE     4
+
+//! EEPROM bytes of the image (header, entries, CRC)
+#define RECORDER_IMAGE_SIZE      (RECORDER_HEADER_SIZE + RECORDER_SIZE * RECORDER_ENTRY_SIZE + 2)
+
+//! start value of the CRC (CRC-CCITT, see hal_crc_ccitt_update())
+#define RECORDER_CRC_INIT        0xFFFF
+
+/**
+ * \brief events recorded
+ */
+typedef enum
+{
+   //! FSM entered a state (value: state)
+   RECORDER_STATE       = 1,
+   //! ISR(TIMER1_CAPT_vect), the bus is silent
+   RECORDER_TIMER1      = 2,
+   //! ISR(TIMER2_COMP_vect), display and systick
+   RECORDER_TIMER2      = 3,
+   //! ISR(INT0_vect) (value: 1, if frames were queued)
+   RECORDER_INT0        = 4,
+   //! frame read from a controller (value: standard CAN id)
+   RECORDER_FRAME       = 5,
+   //! initCAN() failed (value: controller)
+   RECORDER_INIT_FAILED = 6,
+   //! error state entered, the ring is saved (value: state before)
+   RECORDER_ERROR       = 7,
+   //! always the last one
+   NUM_OF_RECORDER_EVENTS
+} eRecorderEvent;
+
+#ifdef RECORDER
+
+// === FUNCTIONS =============================================================
+
+/**
+ * \brief record an event (main loop and ISRs)
+ * \param event to record
+ * \param value of the event
+ */
+void recorder_event(eRecorderEvent event, uint16_t value);
+
+/**
+ * \brief stop recording and save the ring to the EEPROM
+ *
+ * Only the first call saves, so it can be called each pass of the error
+ * state. Writing takes up to ~8.5ms per byte.
+ *
+ * \param state of the FSM before
+ */
+void recorder_save(uint8_t state);
+
+#else
+
+#define recorder_event(event, value)   ((void)(value))
+#define recorder_save(state)           ((void)(state))
+
+#endif
+
+#endif /* RECORDER_H_ */
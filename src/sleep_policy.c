@@ -0,0 +1,124 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file sleep_policy.c
+ *
+ * \date Created: 16.10.2026 23:13:50
+ * \author agent
+ **/
+
+
+#include <stdbool.h>
+
+#include "sleep_policy.h"
+
+// === DEFINITIONS ===========================================================
+
+//! weight of a new interval is 2^-n
+#define SLEEP_POLICY_MEAN_SHIFT  3
+
+//! maximum doublings of the bus silent timeout after spurious wake ups
+#define SLEEP_POLICY_MAX_BACKOFF 4
+
+// === GLOBALS ===============================================================
+
+//! settings
+static sleep_policy_t policy =
+{
+   SLEEP_POLICY_PDC_SHIFT, SLEEP_POLICY_PDC_MIN, SLEEP_POLICY_PDC_MAX,
+   SLEEP_POLICY_BUS_SHIFT, SLEEP_POLICY_BUS_MIN, SLEEP_POLICY_BUS_MAX
+};
+
+//! mean interval between frames in ticks of Timer1, 0 if unknown
+static uint16_t meanInterval = 0;
+
+//! count of Timer1 is an interval of the cadence
+static bool intervalValid = false;
+
+//! frames received since waking up
+static bool framesSinceWake = true;
+
+//! doublings of the bus silent timeout
+static uint8_t backoff = 0;
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief scale mean interval to a timeout
+ * \param shift multiply by 2^shift
+ * \param min minimum timeout
+ * \param max maximum timeout, used if no interval is known
+ * \return timeout in ticks of Timer1
+ */
+static uint16_t sleep_policy_scale(uint8_t shift, uint16_t min, uint16_t max)
+{
+   uint32_t timeout = (uint32_t)meanInterval << shift;
+
+   if((0 == meanInterval) || (timeout > max))
+   {
+      return max;
+   }
+   return (timeout < min) ? min : (uint16_t)timeout;
+}
+
+// === FUNCTIONS =============================================================
+
+void sleep_policy_set(const sleep_policy_t* settings)
+{
+   policy = *settings;
+}
+
+void sleep_policy_frame(uint16_t interval)
+{
+   if(intervalValid)
+   {
+      if(0 == meanInterval)
+      {
+         meanInterval = interval;
+      }
+      else
+      {
+         // exponential moving average without division
+         meanInterval = meanInterval - (meanInterval >> SLEEP_POLICY_MEAN_SHIFT)
+                                     + (interval >> SLEEP_POLICY_MEAN_SHIFT);
+      }
+   }
+   intervalValid   = true;
+   framesSinceWake = true;
+   backoff         = 0;
+}
+
+void sleep_policy_wake(void)
+{
+   intervalValid   = false;
+   framesSinceWake = false;
+}
+
+void sleep_policy_sleep(void)
+{
+   // woken up by unrelated traffic, stay awake longer next time
+   if(!framesSinceWake && (backoff < SLEEP_POLICY_MAX_BACKOFF))
+   {
+      ++backoff;
+   }
+}
+
+uint16_t sleep_policy_pdc_timeout(void)
+{
+   return sleep_policy_scale(policy.pdcShift, policy.pdcMin, policy.pdcMax);
+}
+
+uint16_t sleep_policy_bus_timeout(void)
+{
+   return sleep_policy_scale(policy.busShift + backoff, policy.busMin, policy.busMax);
+}
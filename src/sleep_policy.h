@@ -0,0 +1,133 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file sleep_policy.h
+ *
+ * Timeouts derived from the cadence of the frames received. Timer1 is reset
+ * by each frame, so its count is the time of silence in ticks of 256us:
+ *
+ * * PDC inactive: the values shown are reset, so the LEDs go dark while the
+ *   bus may still be active
+ *
+ * * bus silent: the compare match of Timer1 (ICR1) starts the sleep mode
+ *
+ * Both timeouts are the mean interval between frames shifted left and
+ * clamped to a range. Each wake up without any frame received until
+ * sleeping again (unrelated traffic) doubles the bus silent timeout, up to
+ * its maximum.
+ *
+ * \date Created: 16.10.2026 23:13:50
+ * \author agent
+ **/
+
+
+#ifndef SLEEP_POLICY_H_
+#define SLEEP_POLICY_H_
+
+#include <stdint.h>
+
+#include "config/timer_config.h"
+
+// === DEFINITIONS ===========================================================
+
+/**
+ * \brief convert milliseconds to ticks of Timer1 (4MHz@1024 prescale factor)
+ * \param ms milliseconds up to ~16.7s
+ */
+#define SLEEP_POLICY_MS(ms)      ((uint16_t)(((uint32_t)(ms) * (F_CPU / 1024UL)) / 1000UL))
+
+//! PDC inactive: mean interval multiplied by 2^n
+#define SLEEP_POLICY_PDC_SHIFT   3
+//! PDC inactive: minimum timeout
+#define SLEEP_POLICY_PDC_MIN     SLEEP_POLICY_MS(500)
+//! PDC inactive: maximum timeout
+#define SLEEP_POLICY_PDC_MAX     SLEEP_POLICY_MS(3000)
+
+//! bus silent: mean interval multiplied by 2^n
+#define SLEEP_POLICY_BUS_SHIFT   4
+//! bus silent: minimum timeout
+#define SLEEP_POLICY_BUS_MIN     SLEEP_POLICY_MS(2000)
+//! bus silent: maximum timeout, used as long as no interval is known
+#define SLEEP_POLICY_BUS_MAX     TIMER1_COMPARE_VALUE
+
+//! timeout never reached
+#define SLEEP_POLICY_NEVER       UINT16_MAX
+
+// === TYPE DEFINITIONS ======================================================
+
+/**
+ * \brief settings of the timeouts in ticks of Timer1
+ *
+ * Setting minimum and maximum to the same value gives a fixed timeout.
+ */
+typedef struct
+{
+   //! PDC inactive: mean interval multiplied by 2^n
+   uint8_t  pdcShift;
+   //! PDC inactive: minimum timeout
+   uint16_t pdcMin;
+   //! PDC inactive: maximum timeout
+   uint16_t pdcMax;
+   //! bus silent: mean interval multiplied by 2^n
+   uint8_t  busShift;
+   //! bus silent: minimum timeout
+   uint16_t busMin;
+   //! bus silent: maximum timeout
+   uint16_t busMax;
+} sleep_policy_t;
+
+// === FUNCTIONS =============================================================
+
+/**
+ * \brief change the settings at runtime
+ *
+ * Takes effect with the next frame or wake up.
+ *
+ * \param policy settings to use
+ */
+void sleep_policy_set(const sleep_policy_t* policy);
+
+/**
+ * \brief frames were received
+ *
+ * Needs to be called before Timer1 is reset.
+ *
+ * \param interval count of Timer1, i.e. ticks since the previous frame
+ */
+void sleep_policy_frame(uint16_t interval);
+
+/**
+ * \brief AVR woke up and Timer1 was restarted
+ *
+ * The time until the first frame is no interval of the cadence.
+ */
+void sleep_policy_wake(void);
+
+/**
+ * \brief bus silent timeout was reached
+ */
+void sleep_policy_sleep(void);
+
+/**
+ * \brief get PDC inactive timeout
+ * \return ticks of Timer1 without frame until the values are reset
+ */
+uint16_t sleep_policy_pdc_timeout(void);
+
+/**
+ * \brief get bus silent timeout
+ * \return ticks of Timer1 without frame until sleeping (ICR1)
+ */
+uint16_t sleep_policy_bus_timeout(void);
+
+#endif /* SLEEP_POLICY_H_ */
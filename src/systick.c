@@ -0,0 +1,49 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file systick.c
+ *
+ * \date Created: 16.10.2026 23:33:18
+ * \author agent
+ **/
+
+
+#include "hal.h"
+#include "systick.h"
+
+// === GLOBALS ===============================================================
+
+//! ticks since power on (written by ISR only)
+static volatile uint16_t ticks = 0;
+
+// === FUNCTIONS =============================================================
+
+void systick_advance(uint16_t elapsed)
+{
+   ticks += elapsed;
+}
+
+uint16_t systick_now(void)
+{
+   uint8_t  state = hal_irq_save();
+   uint16_t now   = ticks;
+
+   hal_irq_restore(state);
+
+   return now;
+}
+
+uint16_t systick_since(uint16_t stamp)
+{
+   return (uint16_t)(systick_now() - stamp);
+}
@@ -0,0 +1,68 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file systick.h
+ *
+ * Monotonic time base of the system. Timer2 runs in CTC mode for the
+ * display, so each compare match adds the ticks of the period just ended
+ * (OCR2 + 1). The unit is the prescaler of Timer2 (4MHz@1024, 256us), the
+ * same as of Timer1, independent of the compare values set by the
+ * display.
+ *
+ * The time only advances while Timer2 runs, i.e. not while powered down.
+ * It wraps around after ~16.7s, so only ages below are to be compared.
+ * Reading it costs a few cycles with interrupts disabled.
+ *
+ * \date Created: 16.10.2026 23:33:18
+ * \author agent
+ **/
+
+
+#ifndef SYSTICK_H_
+#define SYSTICK_H_
+
+#include <stdint.h>
+
+// === DEFINITIONS ===========================================================
+
+/**
+ * \brief convert milliseconds to ticks (4MHz@1024 prescale factor)
+ * \param ms milliseconds up to ~16.7s
+ */
+#define SYSTICK_MS(ms)           ((uint16_t)(((uint32_t)(ms) * (F_CPU / 1024UL)) / 1000UL))
+
+//! age never reached
+#define SYSTICK_NEVER            UINT16_MAX
+
+// === FUNCTIONS =============================================================
+
+/**
+ * \brief advance the time (ISR(TIMER2_COMP_vect) only)
+ * \param elapsed ticks since the last call
+ */
+void systick_advance(uint16_t elapsed);
+
+/**
+ * \brief get the time
+ * \return ticks, wrapping around
+ */
+uint16_t systick_now(void);
+
+/**
+ * \brief get ticks elapsed since a time stamp
+ * \param stamp taken by systick_now()
+ * \return ticks, valid up to ~16.7s
+ */
+uint16_t systick_since(uint16_t stamp);
+
+#endif /* SYSTICK_H_ */
@@ -0,0 +1,360 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file telemetry.c
+ *
+ * \date Created: 16.10.2026 23:51:05
+ * \author agent
+ **/
+
+
+#include "hal.h"
+#include "can_rx.h"
+#include "mcp2515_burst.h"
+#include "profiler.h"
+#include "telemetry.h"
+#include "PDCViewer.h"
+
+#ifdef TELEMETRY
+
+// === DEFINITIONS ===========================================================
+
+//! index mask
+#define TELEMETRY_MASK           (TELEMETRY_BUFFER_SIZE - 1)
+
+//! payload of TELEMETRY_STATE
+#define TELEMETRY_STATE_LENGTH      3
+
+//! payload of TELEMETRY_DISTANCES
+#define TELEMETRY_DISTANCES_LENGTH  (3 + NUM_OF_PDC_SENSORS)
+
+//! payload of TELEMETRY_STATS
+#define TELEMETRY_STATS_LENGTH      (2 + 6 * NUM_OF_MCP2515 + 2)
+
+//! payload of TELEMETRY_PROFILE
+#define TELEMETRY_PROFILE_LENGTH    13
+
+//! the largest record fits into the ring
+typedef char telemetry_size_check[(TELEMETRY_FRAME_SIZE(TELEMETRY_TEXT_MAX) <= TELEMETRY_BUFFER_SIZE) &&
+                                  (TELEMETRY_BUFFER_SIZE <= 128) ? 1 : -1];
+
+// === GLOBALS ===============================================================
+
+//! encoded records
+static uint8_t ring[TELEMETRY_BUFFER_SIZE];
+
+/**
+ * \brief end of the records complete, only changed by the main loop
+ *
+ * All indices are free running. A single byte is accessed atomically on
+ * the AVR, so no locking is needed.
+ */
+static volatile uint8_t ringHead = 0;
+
+//! next byte to send, only changed by ISR(USART_UDRE_vect)
+static volatile uint8_t ringTail = 0;
+
+//! write index of the record open
+static uint8_t writeIndex = 0;
+
+//! index of the code byte of the block open
+static uint8_t codeIndex = 0;
+
+//! code of the block open (bytes + 1)
+static uint8_t code = 0;
+
+//! a record is open
+static bool recordOpen = false;
+
+//! characters in the text record open
+static uint8_t textLength = 0;
+
+//! sequence number of the next record
+static uint8_t sequence = 0;
+
+//! records sent
+static uint16_t records = 0;
+
+//! records dropped
+static uint16_t dropped = 0;
+
+//! start of the period running
+static uint16_t periodStart = 0;
+
+//! a byte was written to the UART, so TXC tells the end of sending
+static volatile bool sending = false;
+
+// === HELPERS ===============================================================
+
+/**
+ * \brief get free bytes of the ring
+ * \return bytes
+ */
+static uint8_t telemetry_free(void)
+{
+   return (uint8_t)(TELEMETRY_BUFFER_SIZE - (uint8_t)(ringHead - ringTail));
+}
+
+/**
+ * \brief wait until the ring has space for a record or is empty
+ *
+ * Sleeps in idle mode, each byte sent wakes up. Checking and sleeping is
+ * atomic, so the last byte sent can't be missed.
+ *
+ * \param size of the record
+ */
+static void telemetry_wait(uint8_t size)
+{
+   hal_irq_disable();
+   while(telemetry_free() < size)
+   {
+      hal_sleep(SLEEP_MODE_IDLE);
+      hal_irq_disable();
+   }
+   hal_irq_enable();
+}
+
+/**
+ * \brief encode a byte of the record open (COBS)
+ * \param byte to encode
+ */
+static void telemetry_put(uint8_t byte)
+{
+   if(TELEMETRY_DELIMITER != byte)
+   {
+      ring[writeIndex++ & TELEMETRY_MASK] = byte;
+      ++code;
+   }
+   if((TELEMETRY_DELIMITER == byte) || (TELEMETRY_CODE_MAX == code))
+   {
+      // close the block, the next one starts with its code byte
+      ring[codeIndex & TELEMETRY_MASK] = code;
+      codeIndex = writeIndex++;
+      code      = 1;
+   }
+}
+
+/**
+ * \brief encode a 16bit value (little endian)
+ * \param value to encode
+ */
+static void telemetry_put16(uint16_t value)
+{
+   telemetry_put((uint8_t)value);
+   telemetry_put((uint8_t)(value >> 8));
+}
+
+/**
+ * \brief encode a 32bit value (little endian)
+ * \param value to encode
+ */
+static void telemetry_put32(uint32_t value)
+{
+   telemetry_put16((uint16_t)value);
+   telemetry_put16((uint16_t)(value >> 16));
+}
+
+/**
+ * \brief close the record open and send it
+ */
+static void telemetry_end(void)
+{
+   ring[codeIndex & TELEMETRY_MASK]  = code;
+   ring[writeIndex++ & TELEMETRY_MASK] = TELEMETRY_DELIMITER;
+   recordOpen = false;
+   ++records;
+
+   // record is written completely, publish it now
+   ringHead = writeIndex;
+   hal_uart_irq_enable();
+}
+
+/**
+ * \brief open a record
+ *
+ * The record is encoded directly into the ring, but not sent before
+ * telemetry_end() publishes it.
+ *
+ * \param type of the record
+ * \param length of the payload at most
+ * \return false, if the record does not fit (it is counted as dropped)
+ */
+static bool telemetry_begin(eTelemetryType type, uint8_t length)
+{
+   // the gap of the sequence numbers shows the records dropped
+   uint8_t seq = sequence++;
+
+   if(recordOpen)
+   {
+      // text without the end of the line
+      telemetry_end();
+   }
+   if(telemetry_free() < TELEMETRY_FRAME_SIZE(length))
+   {
+      ++dropped;
+      return false;
+   }
+
+   writeIndex = ringHead;
+   codeIndex  = writeIndex++;
+   code       = 1;
+   recordOpen = true;
+
+   telemetry_put((uint8_t)type);
+   telemetry_put(seq);
+   return true;
+}
+
+// === ISR ===================================================================
+
+/**
+ * \brief interrupt service routine for UART data register empty
+ *
+ * Sends the next byte of the ring. The interrupt is disabled, if the ring
+ * is empty, and enabled again by the next record.
+ **/
+ISR(USART_UDRE_vect)
+{
+   PROFILE_BEGIN(PROF_ISR_UART);
+   uint8_t tail = ringTail;
+
+   if(tail != ringHead)
+   {
+      hal_uart_put(ring[tail & TELEMETRY_MASK]);
+      ringTail = tail + 1;
+      sending  = true;
+   }
+   else
+   {
+      hal_uart_irq_disable();
+   }
+   PROFILE_END(PROF_ISR_UART);
+}
+
+// === FUNCTIONS =============================================================
+
+void telemetry_init(void)
+{
+   hal_uart_init(TELEMETRY_BAUD);
+   periodStart = systick_now();
+}
+
+void telemetry_state(uint8_t state)
+{
+   PROFILE_BEGIN(PROF_TELEMETRY);
+   if(telemetry_begin(TELEMETRY_STATE, TELEMETRY_STATE_LENGTH))
+   {
+      telemetry_put16(systick_now());
+      telemetry_put(state);
+      telemetry_end();
+   }
+   PROFILE_END(PROF_TELEMETRY);
+}
+
+void telemetry_distances(uint8_t slots, const uint8_t* values)
+{
+   PROFILE_BEGIN(PROF_TELEMETRY);
+   uint8_t i;
+
+   if(telemetry_begin(TELEMETRY_DISTANCES, TELEMETRY_DISTANCES_LENGTH))
+   {
+      telemetry_put16(systick_now());
+      telemetry_put(slots);
+      for(i = 0; i < NUM_OF_PDC_SENSORS; ++i)
+      {
+         telemetry_put(values[i]);
+      }
+      telemetry_end();
+   }
+   PROFILE_END(PROF_TELEMETRY);
+}
+
+void telemetry_profile(uint8_t probe, uint32_t count, uint16_t min, uint16_t max,
+                       uint32_t sum)
+{
+   if(telemetry_begin(TELEMETRY_PROFILE, TELEMETRY_PROFILE_LENGTH))
+   {
+      telemetry_put(probe);
+      telemetry_put32(count);
+      telemetry_put16(min);
+      telemetry_put16(max);
+      telemetry_put32(sum);
+      telemetry_end();
+   }
+}
+
+void telemetry_putc(char c)
+{
+   if(!recordOpen)
+   {
+      telemetry_wait(TELEMETRY_FRAME_SIZE(TELEMETRY_TEXT_MAX));
+      telemetry_begin(TELEMETRY_TEXT, TELEMETRY_TEXT_MAX);
+      textLength = 0;
+   }
+
+   telemetry_put((uint8_t)c);
+   if(('\n' == c) || (TELEMETRY_TEXT_MAX == ++textLength))
+   {
+      telemetry_end();
+   }
+}
+
+void telemetry_poll(void)
+{
+   uint8_t chip;
+
+   if(systick_since(periodStart) < TELEMETRY_PERIOD)
+   {
+      return;
+   }
+   periodStart += TELEMETRY_PERIOD;
+
+   PROFILE_BEGIN(PROF_TELEMETRY);
+   if(telemetry_begin(TELEMETRY_STATS, TELEMETRY_STATS_LENGTH))
+   {
+      telemetry_put16(systick_now());
+      for(chip = 0; chip < NUM_OF_MCP2515; ++chip)
+      {
+         telemetry_put16(can_rx_frames((eChipSelect)chip));
+         telemetry_put16(can_rx_dropped((eChipSelect)chip));
+         telemetry_put16((uint16_t)(mcp2515_rx_overflows((eChipSelect)chip, 0) +
+                                    mcp2515_rx_overflows((eChipSelect)chip, 1)));
+      }
+      telemetry_put16(dropped);
+      telemetry_end();
+   }
+   PROFILE_END(PROF_TELEMETRY);
+}
+
+void telemetry_flush(void)
+{
+   telemetry_wait(TELEMETRY_BUFFER_SIZE);
+   // the ring is empty, the interrupt would wake up right away otherwise
+   hal_uart_irq_disable();
+   // the last byte is still shifted out
+   while(sending && !hal_uart_sent())
+   {
+   }
+}
+
+uint16_t telemetry_dropped(void)
+{
+   return dropped;
+}
+
+uint16_t telemetry_records(void)
+{
+   return records;
+}
+
+#endif
@@ -0,0 +1,186 @@
+/**
+ * ----------------------------------------------------------------------------
+ *
+ * "THE ANY BEVERAGE-WARE LICENSE" (Revision 42 - based on beer-ware license):
+ * <agent@local> wrote this file. As long as you retain this notice you
+ * can do whatever you want with this stuff. If we meet some day, and you think
+ * this stuff is worth it, you can buy me a be(ve)er(age) in return. (I don't
+ * like beer much.)
+ *
+ * agent
+ *
+ * ----------------------------------------------------------------------------
+ *
+ * \file telemetry.h
+ *
+ * Binary telemetry via UART TX (PD1). Records are COBS encoded directly into
+ * a ring buffer and terminated by 0x00, so a receiver synchronizes at any
+ * frame boundary. ISR(USART_UDRE_vect) sends the ring byte by byte, the
+ * main loop never waits for the UART:
+ *
+ * * a record not fitting into the ring is dropped and counted, the
+ *   sequence number of the next one shows the gap
+ * * only text of the debug channel waits for space, since the dumps are
+ *   not part of the hot path
+ *
+ * Each record starts with its type and a sequence number, followed by the
+ * payload (little endian, time in ticks of systick.h):
+ *
+ * | type                | payload                                           |
+ * |---------------------|---------------------------------------------------|
+ * | TELEMETRY_TEXT      | characters of the debug channel                   |
+ * | TELEMETRY_STATE     | time, state of the FSM entered                    |
+ * | TELEMETRY_DISTANCES | time, slots decoded, values shown per sensor      |
+ * | TELEMETRY_STATS     | time, frames, dropped, overflows per controller,  |
+ * |                     | records dropped (counters wrap around)            |
+ * | TELEMETRY_PROFILE   | probe, count, min, max, sum of the last period    |
+ *
+ * Records are written by the main loop only. The host decodes the stream
+ * by PDCTelemetry.
+ *
+ * Only active, if TELEMETRY is defined (cmake -DWITH_TELEMETRY=ON).
+ * Otherwise all macros are empty.
+ *
+ * \date Created: 16.10.2026 23:51:05
+ * \author agent
+ **/
+
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "systick.h"
+
+// === DEFINITIONS ===========================================================
+
+//! baud rate of the UART (exact at 4MHz with U2X)
+#define TELEMETRY_BAUD           250000UL
+
+/**
+ * \brief bytes buffered for the UART
+ *
+ * Needs to be 2^n and not larger than 128, since the free running 8bit
+ * indices are used to distinguish between full and empty.
+ */
+#define TELEMETRY_BUFFER_SIZE    64
+
+//! maximum characters of the debug channel per record
+#define TELEMETRY_TEXT_MAX       32
+
+//! period of the statistics and profiling records
+#define TELEMETRY_PERIOD         SYSTICK_MS(1000)
+
+//! frame delimiter
+#define TELEMETRY_DELIMITER      0x00
+
+//! largest COBS code (254 bytes not followed by a zero)
+#define TELEMETRY_CODE_MAX       0xFF
+
+//! bytes of the header (type, sequence number)
+#define TELEMETRY_HEADER         2
+
+/**
+ * \brief bytes needed in the ring for a record
+ *
+ * COBS adds one code byte per 254 bytes, the delimiter ends the frame.
+ *
+ * \param length of the payload
+ */
+#define TELEMETRY_FRAME_SIZE(length)   (TELEMETRY_HEADER + (length) + 2)
+
+/**
+ * \brief types of the records
+ */
+typedef enum
+{
+   //! characters of the debug channel
+   TELEMETRY_TEXT       = 1,
+   //! state of the FSM entered
+   TELEMETRY_STATE      = 2,
+   //! values of the sensors shown
+   TELEMETRY_DISTANCES  = 3,
+   //! counters of the buses
+   TELEMETRY_STATS      = 4,
+   //! statistics of a probe of the profiler
+   TELEMETRY_PROFILE    = 5
+} eTelemetryType;
+
+#ifdef TELEMETRY
+
+// === FUNCTIONS =============================================================
+
+/**
+ * \brief initialize UART and ring buffer
+ */
+void telemetry_init(void);
+
+/**
+ * \brief send entering a state of the FSM
+ * \param state entered
+ */
+void telemetry_state(uint8_t state);
+
+/**
+ * \brief send values of the sensors shown
+ * \param slots decoded by the last frame(s)
+ * \param values of all sensors (NUM_OF_PDC_SENSORS)
+ */
+void telemetry_distances(uint8_t slots, const uint8_t* values);
+
+/**
+ * \brief send a sample of a probe of the profiler
+ * \param probe measured
+ * \param count of measurements
+ * \param min duration
+ * \param max duration
+ * \param sum of all durations
+ */
+void telemetry_profile(uint8_t probe, uint32_t count, uint16_t min, uint16_t max,
+                       uint32_t sum);
+
+/**
+ * \brief send a character of the debug channel
+ *
+ * Characters are collected in a record up to TELEMETRY_TEXT_MAX or the end
+ * of the line. Waits for space in the ring, interrupts need to be enabled.
+ *
+ * \param c character
+ */
+void telemetry_putc(char c);
+
+/**
+ * \brief send the statistics each TELEMETRY_PERIOD (main loop, each tick)
+ */
+void telemetry_poll(void);
+
+/**
+ * \brief wait until all records are sent, e.g. before powering down
+ */
+void telemetry_flush(void);
+
+/**
+ * \brief get number of records dropped by a full ring
+ * \return records since start (wraps around)
+ */
+uint16_t telemetry_dropped(void);
+
+/**
+ * \brief get number of records sent
+ * \return records since start (wraps around)
+ */
+uint16_t telemetry_records(void);
+
+#else
+
+#define telemetry_init()
+#define telemetry_state(state)               ((void)(state))
+#define telemetry_distances(slots, values)   ((void)(slots))
+#define telemetry_poll()
+#define telemetry_flush()
+
+#endif
+
+#endif /* TELEMETRY_H_ */